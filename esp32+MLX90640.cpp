@@ -6,46 +6,59 @@
 #include <ESPmDNS.h>
 #include <WiFiUdp.h>
 #include <ArduinoOTA.h>
+#include <pipeline.h>
+#include "frame_mask.h"
 
 WebServer server(80);
 
 Adafruit_MLX90640 mlx;
 
-const unsigned long getFrameInterval = 1000;
-unsigned long previousFrameTime = 0;
-
 const float humanThreshold = 3.5;
 
 const int rows = 24;
 const int cols = 32;
 const int total_pixels = rows * cols;
-float pixels[total_pixels];
-float frame[rows][cols];
+FrameMask hotMask;
+FrameMask warmMask;
+FrameMask warmNeighbours;
+
+// Result of the processing task, handed to the serving task through a one slot mailbox
+struct ComputedFrame
+{
+  float pixels[total_pixels];
+  float min;
+  float max;
+  float avg;
+  bool person_detected;
+  uint32_t sequence;
+};
+
+Pipeline pipeline;
+QueueHandle_t computedMailbox;
+ComputedFrame computed;   // processing task only
+ComputedFrame served;      // serving task only
+uint32_t computedFrames = 0;
 
 String output;
 
 const char *sensor = "MLX90640";
 
-float getPixel(int x, int y)
+// Pipeline stages: the sensor read blocks for a frame time, so it has a task of its own
+bool acquireFrame(void *buffer, void *context)
 {
-  if (x <= rows && x > 0 && y <= cols && y > 0)
+  if (mlx.getFrame((float *)buffer) != 0)
   {
-    return frame[x][y];
+    Serial.println("getFrame: failed");
+    return false;
   }
-  return (float)0.0;
+  return true;
 }
 
-void getRaw()
+void processFrame(const void *buffer, void *context)
 {
-  String new_output;
-  String data;
-
-  StaticJsonDocument<4096> doc;
-
+  const float *pixels = (const float *)buffer;
   bool person_detected = false;
   float personThreshold = 0;
-  int col = 0;
-  int row = 0;
   float pixel_temperature;
   float min = 0;
   float max = 0;
@@ -65,79 +78,58 @@ void getRaw()
     }
 
     avg += pixel_temperature;
-
-    data.concat(String(pixel_temperature, 1));
-
-    if (i < total_pixels - 1)
-    {
-      data.concat(",");
-    }
   }
 
   avg = avg / total_pixels;
   personThreshold = humanThreshold + avg;
 
-  for (int i = 0; i < total_pixels; i++)
+  // a person is a hot pixel with more than 3 warm neighbours, rows at once on the bit masks
+  maskThreshold(hotMask, pixels, rows, cols, personThreshold);
+  maskThreshold(warmMask, pixels, rows, cols, personThreshold - 2);
+  maskNeighbours(warmMask, 4, warmNeighbours);
+  maskAnd(hotMask, warmNeighbours, warmNeighbours);
+  person_detected = maskAny(warmNeighbours);
+
+  memcpy(computed.pixels, pixels, sizeof(computed.pixels));
+  computed.min = min;
+  computed.max = max;
+  computed.avg = avg;
+  computed.person_detected = person_detected;
+  computed.sequence = ++computedFrames;
+  xQueueOverwrite(computedMailbox, &computed);
+}
+
+void serveClients(void *context)
+{
+  server.handleClient();
+  ArduinoOTA.handle();
+}
+
+// Builds the payload from the latest computed frame, runs on the serving task
+void getRaw()
+{
+  String new_output;
+  String data;
+  char number[16];
+
+  // data is stored as a pointer, so the document only holds the members
+  StaticJsonDocument<JSON_OBJECT_SIZE(8)> doc;
+
+  if (xQueuePeek(computedMailbox, &served, 0) != pdTRUE)
   {
-    frame[row][col] = pixels[i];
-    if (col == cols)
-    {
-      col = 0;
-      row++;
-    }
-    else
-    {
-      col++;
-    }
+    output = "{}";
+    return;
   }
 
-  for (int r = 0; r < rows; r++)
+  data.reserve(total_pixels * 6);
+  for (int i = 0; i < total_pixels; i++)
   {
-    for (int c = 0; c < cols; c++)
+    snprintf(number, sizeof(number), "%.1f", served.pixels[i]);
+    data.concat(number);
+
+    if (i < total_pixels - 1)
     {
-      if (getPixel(r, c) > personThreshold)
-      {
-        int blobSize = 1;
-
-        if (getPixel(r + 1, c - 1) > personThreshold - 2)
-        {
-          blobSize++;
-        }
-        if (getPixel(r + 1, c) > personThreshold - 2)
-        {
-          blobSize++;
-        }
-        if (getPixel(r + 1, c + 1) > personThreshold - 2)
-        {
-          blobSize++;
-        }
-        if (getPixel(r, c + 1) > personThreshold - 2)
-        {
-          blobSize++;
-        }
-        if (getPixel(r, c - 1) > personThreshold - 2)
-        {
-          blobSize++;
-        }
-        if (getPixel(r - 1, c - 1) > personThreshold - 2)
-        {
-          blobSize++;
-        }
-        if (getPixel(r - 1, c) > personThreshold - 2)
-        {
-          blobSize++;
-        }
-        if (getPixel(r - 1, c + 1) > personThreshold - 2)
-        {
-          blobSize++;
-        }
-
-        if (blobSize > 4)
-        {
-          person_detected = true;
-        }
-        
-      }
+      data.concat(",");
     }
   }
 
@@ -145,10 +137,10 @@ void getRaw()
   doc["rows"] = rows;
   doc["cols"] = cols;
   doc["data"] = data.c_str();
-  doc["min"] = min;
-  doc["max"] = max;
-  doc["avg"] = avg;
-  doc["person_detected"] = person_detected;
+  doc["min"] = served.min;
+  doc["max"] = served.max;
+  doc["avg"] = served.avg;
+  doc["person_detected"] = served.person_detected;
 
   serializeJson(doc, new_output);
   output = new_output;
@@ -160,6 +152,46 @@ void sendRaw()
   server.send(200, "application/json", output.c_str());
 }
 
+void addStage(String &stats, const char *name, const PipelineStage &stage)
+{
+  stats += "\"";
+  stats += name;
+  stats += "\":{\"count\":";
+  stats += stage.count;
+  stats += ",\"last_us\":";
+  stats += stage.lastUs;
+  stats += ",\"avg_us\":";
+  stats += stage.count ? (uint32_t)(stage.totalUs / stage.count) : 0;
+  stats += ",\"max_us\":";
+  stats += stage.maxUs;
+  stats += "},";
+}
+
+// Per-stage timing of the pipeline, http://<ip>/stats?reset=1 starts a new measurement
+void sendStats()
+{
+  String stats = "{";
+  addStage(stats, "acquire", pipeline.stats.acquire);
+  addStage(stats, "wait", pipeline.stats.wait);
+  addStage(stats, "process", pipeline.stats.process);
+  addStage(stats, "serve", pipeline.stats.serve);
+  stats += "\"errors\":";
+  stats += pipeline.stats.errors;
+  stats += ",\"dropped\":";
+  stats += pipeline.stats.dropped;
+  stats += ",\"ready_high_water\":";
+  stats += pipeline.stats.readyHighWater;
+  stats += ",\"frames\":";
+  stats += computedFrames;
+  stats += "}";
+  server.send(200, "application/json", stats.c_str());
+
+  if (server.hasArg("reset"))
+  {
+    pipelineResetStats(pipeline);
+  }
+}
+
 void notFound()
 {
   server.send(404, "text/plain", "Not found");
@@ -293,23 +325,30 @@ void setup()
   ArduinoOTA.begin();
 
   server.on("/raw", sendRaw);
+  server.on("/stats", sendStats);
 
   server.onNotFound(notFound);
 
   server.begin();
+
+  computedMailbox = xQueueCreate(1, sizeof(ComputedFrame));
+
+  PipelineConfig config;
+  pipelineDefaults(config);
+  config.frameBytes = sizeof(float) * total_pixels;
+  config.acquire = acquireFrame;
+  config.process = processFrame;
+  config.serve = serveClients;
+  if (computedMailbox == NULL || !pipelineStart(pipeline, config))
+  {
+    Serial.println("Pipeline start failed");
+    while (1)
+      delay(10);
+  }
 }
 
+// Everything runs in the pipeline tasks
 void loop()
 {
-  unsigned long currentTime = millis();
-  if (currentTime - previousFrameTime >= getFrameInterval)
-  {
-    if (mlx.getFrame(pixels) != 0)
-    {
-      Serial.println("getFrame: failed");
-    }
-    previousFrameTime = currentTime;
-  }
-  server.handleClient();
-  ArduinoOTA.handle();
+  vTaskDelete(NULL);
 }
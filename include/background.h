@@ -0,0 +1,76 @@
+#ifndef BACKGROUND_H
+#define BACKGROUND_H
+
+#include <stdint.h>
+#include <string.h>
+#include "frame_mask.h"
+
+// Per pixel background temperature as an exponentially weighted mean and
+// variance. Classification and learning share one pass over the frame: a pixel
+// warmer than its mean by more than zThreshold standard deviations is
+// foreground and left out of the update, so a person standing still is not
+// learned, while slow changes (sun on a wall, a radiator warming up) are.
+// Every pixel is seeded with its own first valid reading; a variance of 0 marks
+// a pixel not seeded yet (learning never goes below minVariance), so a pixel
+// that reads NaN at start is picked up once it delivers a number.
+
+// variance of a freshly started model, 1 K standard deviation
+#define BACKGROUND_INITIAL_VARIANCE 1.0f
+
+struct BackgroundConfig
+{
+    float alpha;       // learning rate per frame
+    float zThreshold;  // foreground above mean + zThreshold * standard deviation
+    float minVariance; // floor so a very steady pixel does not flag sensor noise, above 0
+};
+
+struct BackgroundState
+{
+    BackgroundConfig config;
+    uint32_t frames; // frames learned, sets the learning rate
+};
+
+template <int Rows, int Cols>
+struct BackgroundModel
+{
+    BackgroundState state;
+    float mean[Rows * Cols];
+    float variance[Rows * Cols];
+};
+
+BackgroundConfig backgroundDefaults();
+
+// Sets foreground (rows x cols) from frame (row by row) and learns the other
+// pixels; until 1 / alpha frames are learned the rate is 1 / frames, so the
+// model settles quickly after a start or reset. Pixels not seeded yet are
+// seeded and never foreground.
+void backgroundUpdate(BackgroundState &state, float *mean, float *variance, const float *frame, int rows, int cols,
+                      FrameMask &foreground);
+
+// forgets the learned scene, e.g. after the sensor was moved
+template <int Rows, int Cols>
+void backgroundReset(BackgroundModel<Rows, Cols> &model)
+{
+    model.state.frames = 0;
+    memset(model.mean, 0, sizeof(model.mean));
+    memset(model.variance, 0, sizeof(model.variance));
+}
+
+template <int Rows, int Cols>
+void backgroundInit(BackgroundModel<Rows, Cols> &model, const BackgroundConfig &config)
+{
+    model.state.config = config;
+    backgroundReset(model);
+}
+
+template <int Rows, int Cols>
+void backgroundUpdate(BackgroundModel<Rows, Cols> &model, const float *frame, int rows, int cols, FrameMask &foreground)
+{
+    if (rows * cols > Rows * Cols)
+    {
+        rows = 0;
+    }
+    backgroundUpdate(model.state, model.mean, model.variance, frame, rows, cols, foreground);
+}
+
+#endif
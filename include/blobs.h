@@ -0,0 +1,72 @@
+#ifndef BLOBS_H
+#define BLOBS_H
+
+#include <stdint.h>
+#include "frame_mask.h"
+
+// Connected regions (8-neighbourhood) of the pixels set in a FrameMask, found
+// in a single row by row pass that only visits set bits: each pixel joins the label of its upper and left
+// neighbours, touching labels are merged with union-find and every label keeps
+// running statistics, so no label image and no second pass are needed.
+
+#define BLOB_MAX_BLOBS 16
+
+struct Blob
+{
+    uint16_t area;
+    float centroidRow;
+    float centroidCol;
+    uint8_t top;
+    uint8_t left;
+    uint8_t bottom;
+    uint8_t right;
+    float peak;
+    uint16_t peakIndex; // row * cols + col
+};
+
+// The largest blobs, biggest first
+struct BlobList
+{
+    uint8_t count;
+    bool overflow; // more blobs than BLOB_MAX_BLOBS or labels than the workspace holds
+    Blob blobs[BLOB_MAX_BLOBS];
+};
+
+struct BlobRegion
+{
+    uint16_t parent;
+    uint16_t area;
+    uint32_t sumRow;
+    uint32_t sumCol;
+    uint8_t top;
+    uint8_t left;
+    uint8_t bottom;
+    uint8_t right;
+    float peak;
+    uint16_t peakIndex;
+};
+
+// A new label needs a pixel without labelled upper or left neighbours, which
+// happens at most once per 2x2 cell; label 0 is the background.
+template <int Rows, int Cols>
+struct BlobWorkspace
+{
+    static const int labels = ((Rows + 1) / 2) * ((Cols + 1) / 2) + 1;
+    BlobRegion regions[labels];
+    uint16_t rowLabels[2][Cols];
+};
+
+// frame holds the temperatures for the peaks (mask.rows x mask.cols, row by
+// row); blobs smaller than minArea are left out
+void findBlobs(const FrameMask &mask, const float *frame, uint16_t minArea, BlobRegion *regions,
+               uint16_t regionCount, uint16_t *rowLabels, BlobList &list);
+
+template <int Rows, int Cols>
+void findBlobs(const FrameMask &mask, const float *frame, uint16_t minArea, BlobWorkspace<Rows, Cols> &workspace,
+               BlobList &list)
+{
+    findBlobs(mask, frame, minArea, workspace.regions, mask.rows <= Rows && mask.cols <= Cols ? workspace.labels : 0,
+              &workspace.rowLabels[0][0], list);
+}
+
+#endif
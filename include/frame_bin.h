@@ -0,0 +1,41 @@
+#ifndef FRAME_BIN_H
+#define FRAME_BIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "frame_store.h"
+
+// Binary frame format served by /frame.bin, all fields little-endian:
+//
+//   0  char[4]  magic "TVFB"
+//   4  uint8    version (FRAME_BIN_VERSION)
+//   5  uint8    flags (FRAME_BIN_DELTA)
+//   6  uint16   header size, pixels start here
+//   8  char[8]  sensor name, NUL padded
+//  16  uint8    rows
+//  17  uint8    cols
+//  18  uint16   scale, pixel and Ta units per degree C
+//  20  uint32   timestamp, ms since boot
+//  24  uint32   sequence number of the frame
+//  28  int16    Ta
+//  30  uint16   reserved
+//
+// followed by rows * cols pixels in the /raw order (row by row). Without
+// FRAME_BIN_DELTA each pixel is an int16; with it each is the zigzag varint
+// coded difference to the same pixel of frame sequence - 1. FRAME_BIN_INVALID
+// marks pixels that were not a number.
+#define FRAME_BIN_VERSION 1
+#define FRAME_BIN_HEADER_SIZE 32
+#define FRAME_BIN_DELTA 0x01
+#define FRAME_BIN_SCALE 100
+#define FRAME_BIN_INVALID FRAME_STORE_INVALID
+#define FRAME_BIN_MAX_PIXELS FRAME_STORE_MAX_PIXELS
+// a zigzag varint of a 16 bit difference takes at most 3 bytes
+#define FRAME_BIN_MAX_BYTES (FRAME_BIN_HEADER_SIZE + FRAME_BIN_MAX_PIXELS * 3)
+
+// Writes frame, as a delta if previous is the frame before it; returns the
+// length or 0 if size is too small.
+size_t frameBinEncode(const StoredFrame &frame, const StoredFrame *previous, const char *sensor, uint8_t *out,
+                      size_t size);
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef FRAME_JSON_H
+#define FRAME_JSON_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Longest number written by frameJsonNumber: "-10000000.00", larger magnitudes are clamped
+#define FRAME_JSON_NUMBER_CHARS 12
+#define FRAME_JSON_NUMBER_MAX 10000000.0f
+// Pieces handed to the writer are at most this long; the encoder keeps one on the stack
+#ifndef FRAME_JSON_CHUNK_BYTES
+#define FRAME_JSON_CHUNK_BYTES 512
+#endif
+// Pixel value that is written as "nan"
+#define FRAME_JSON_INVALID INT16_MIN
+#define FRAME_JSON_MAX_TRACKS 8
+
+// Tracked person, position in pixels (row, col) of the frame
+struct FrameTrack
+{
+    uint16_t id;
+    float row;
+    float col;
+};
+
+struct FrameSummary
+{
+    float avg;
+    float min;
+    float max;
+    uint8_t minIndex;
+    uint8_t maxIndex;
+    bool overflow;
+    bool movingAverageEnabled;
+    bool personDetected;
+    uint8_t personCount;
+    uint8_t trackCount;
+    FrameTrack tracks[FRAME_JSON_MAX_TRACKS];
+    uint32_t lineIn;
+    uint32_t lineOut;
+};
+
+typedef void (*FrameJsonWrite)(const char *data, size_t length, void *context);
+
+// Writes value with two decimals like String(value, 2) ("nan", "inf" and "-inf"
+// included); returns the number of characters, out needs FRAME_JSON_NUMBER_CHARS.
+int frameJsonNumber(char *out, float value);
+// Same for a value in hundredths
+int frameJsonCenti(char *out, int32_t centi);
+
+// Streams the /raw payload ({"sensor":..,"rows":..,"cols":..,"data":"t0,t1,..",
+// "temp":..,"avg":..,"min":..,"max":..,"min_index":..,"max_index":..,
+// "overflow":..,"movingAverageEnabled":..,"person_detected":..,"person_count":..,
+// "tracks":[{"id":..,"row":..,"col":..}],"line_in":..,"line_out":..}) through write
+// in pieces of up to FRAME_JSON_CHUNK_BYTES; pixels are hundredths of a degree.
+// Returns the total length.
+size_t frameJsonStream(const char *sensor, int rows, int cols, const int16_t *centi, const FrameSummary &summary,
+                       FrameJsonWrite write, void *context);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef FRAME_MASK_H
+#define FRAME_MASK_H
+
+#include <stdint.h>
+
+// Thresholded frame as one 32 bit word per row, bit c for column c (both
+// sensors have at most 32 columns). Neighbourhood operations work on whole
+// rows with shifts: the left neighbours of a row are row << 1, the right ones
+// row >> 1, and per pixel counts are kept bit-sliced, one word per count bit.
+
+#define FRAME_MASK_MAX_ROWS 32
+
+struct FrameMask
+{
+    uint8_t rows;
+    uint8_t cols;
+    uint32_t bits[FRAME_MASK_MAX_ROWS];
+};
+
+// pixels of frame (rows x cols, row by row) above threshold
+void maskThreshold(FrameMask &mask, const float *frame, int rows, int cols, float threshold);
+int maskCount(const FrameMask &mask);
+bool maskAny(const FrameMask &mask);
+void maskAnd(const FrameMask &a, const FrameMask &b, FrameMask &out);
+// pixels with at least minimum of their 8 neighbours set, whether set themselves or not
+void maskNeighbours(const FrameMask &mask, int minimum, FrameMask &out);
+// 3x3 morphology, pixels outside the frame count as clear
+void maskDilate(const FrameMask &mask, FrameMask &out);
+void maskErode(const FrameMask &mask, FrameMask &out);
+
+static inline bool maskTest(const FrameMask &mask, int r, int c)
+{
+    return (mask.bits[r] >> c) & 1;
+}
+
+#endif
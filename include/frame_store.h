@@ -0,0 +1,59 @@
+#ifndef FRAME_STORE_H
+#define FRAME_STORE_H
+
+#include <atomic>
+#include <stdint.h>
+#include "frame_json.h"
+
+// Computed frames handed from the producer (acquisition and detection) to the
+// request handlers. Frames go to alternating slots, each guarded by a sequence
+// lock: the producer only ever writes the slot readers are not directed to, and
+// a reader that still raced with it (it was two frames behind) sees the slot
+// version change and copies again. Neither side blocks. One producer, any
+// number of readers.
+//
+// The reader's memcpy of a slot the producer may be writing is formally a data
+// race in the C++ memory model (ThreadSanitizer reports it). Only the version
+// re-check after the copy guards it: a copy that overlapped a write is thrown
+// away, never used. test/test_frame_store hammers this from several threads.
+
+#define FRAME_STORE_MAX_PIXELS 192
+// pixel that was not a number
+#define FRAME_STORE_INVALID INT16_MIN
+#define FRAME_STORE_READ_RETRIES 8
+
+struct StoredFrame
+{
+    uint32_t sequence; // 1 for the first frame
+    uint32_t timestamp; // ms since boot
+    uint8_t rows;
+    uint8_t cols;
+    int16_t ta; // hundredths of a degree, like the pixels
+    FrameSummary summary;
+    int16_t pixels[FRAME_STORE_MAX_PIXELS]; // hundredths of a degree, row by row
+};
+
+struct FrameStoreSlot
+{
+    std::atomic<uint32_t> version; // odd while the producer writes the frame
+    StoredFrame frame;
+};
+
+struct FrameStore
+{
+    FrameStoreSlot slots[2];
+    std::atomic<uint32_t> latest; // sequence of the last published frame, 0 before the first
+};
+
+// Degrees to hundredths, clamped to the int16 range
+int16_t frameStoreCenti(float value);
+
+// Producer: returns the frame to fill for sequence latest + 1, then publishes it
+StoredFrame *frameStoreBegin(FrameStore &store);
+void frameStorePublish(FrameStore &store);
+
+// Reader: copies frame sequence (0 for the latest) into frame; false if there is
+// none yet, it was overwritten or the producer kept racing the copy.
+bool frameStoreRead(const FrameStore &store, uint32_t sequence, StoredFrame &frame);
+
+#endif
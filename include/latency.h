@@ -0,0 +1,22 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <Arduino.h>
+
+// Log2 histogram of durations: bucket n counts samples of [2^n, 2^(n+1)) us,
+// bucket 0 also takes 0 us and the last bucket everything above.
+#define LATENCY_BUCKETS 24
+
+struct LatencyHistogram
+{
+    uint32_t buckets[LATENCY_BUCKETS];
+    uint32_t count;
+    uint32_t maxUs;
+    uint64_t totalUs;
+};
+
+void latencyRecord(LatencyHistogram &histogram, uint32_t us);
+void latencyReset(LatencyHistogram &histogram);
+String latencyToJson(const LatencyHistogram &histogram);
+
+#endif
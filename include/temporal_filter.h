@@ -0,0 +1,90 @@
+#ifndef TEMPORAL_FILTER_H
+#define TEMPORAL_FILTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Per pixel temporal denoising between compensation and detection. Smoothing
+// a few frames lowers the pixel noise, which allows a lower ADC resolution
+// and a faster refresh rate for the same detection quality.
+//
+//   average  mean of the last window frames, kept in a ring of centi-degrees
+//            with a running sum per pixel, so it costs the same for any window
+//   ewma     out += alpha * (in - out)
+//   kalman   random walk model per pixel; an innovation beyond gate standard
+//            deviations restarts the pixel at the measurement, so a person
+//            walking in is not smeared over several frames
+//
+// Only the state of the active kind is allocated, in one block on the first
+// frame after a change: 4 bytes per pixel for ewma, 8 for kalman and 8 plus 2
+// per window frame for average, nothing while off. Filtering also gathers the
+// range of the output so no further pass is needed for the payload summary.
+
+#define TEMPORAL_FILTER_OFF 0
+#define TEMPORAL_FILTER_AVERAGE 1
+#define TEMPORAL_FILTER_EWMA 2
+#define TEMPORAL_FILTER_KALMAN 3
+
+#define TEMPORAL_FILTER_MAX_WINDOW 8
+
+struct TemporalFilterConfig
+{
+    uint8_t kind;
+    uint8_t window;         // average: frames, 1 to TEMPORAL_FILTER_MAX_WINDOW
+    float alpha;            // ewma: weight of the new frame
+    float processNoise;     // kalman: variance the scene gains per frame, K^2
+    float measurementNoise; // kalman: pixel noise variance, K^2
+    float gate;             // kalman: restart threshold in standard deviations, 0 disables
+};
+
+struct TemporalFilterState
+{
+    TemporalFilterConfig config;
+    uint8_t filled; // frames in the ring, 0 restarts the filter with the next frame
+    uint8_t head;   // ring slot of the next frame
+};
+
+// Must start zeroed (a global does)
+struct TemporalFilter
+{
+    TemporalFilterState state;
+    uint16_t pixels;
+    uint8_t kind;   // kind the block is laid out for
+    uint8_t window; // average: frames the history holds
+    void *block;    // NULL while off or when the allocation failed
+    int16_t *history;
+    int32_t *sum;
+    float *output;
+    float *variance;
+};
+
+// Range of the filtered frame, indices into it
+struct TemporalFilterRange
+{
+    float min;
+    float max;
+    float sum;
+    uint16_t argMin;
+    uint16_t argMax;
+    uint16_t count; // pixels that are a number
+};
+
+TemporalFilterConfig temporalFilterDefaults();
+const char *temporalFilterName(uint8_t kind);
+// Kind for a name of temporalFilterName, -1 if unknown
+int temporalFilterParse(const char *name);
+
+// Returns the filtered frame (output), or frame itself while the filter is off
+// in which case range is left untouched
+const float *temporalFilterApply(TemporalFilterState &state, int16_t *history, int32_t *sum, float *output,
+                                 float *variance, const float *frame, int pixels, TemporalFilterRange &range);
+
+// Sets up a filter for frames of up to pixels, releasing the state it had
+void temporalFilterInit(TemporalFilter &filter, int pixels, const TemporalFilterConfig &config);
+// Same as above, allocating the state for the configured kind first; while that
+// fails the frame is returned unfiltered
+const float *temporalFilterApply(TemporalFilter &filter, const float *frame, int pixels, TemporalFilterRange &range);
+// Bytes allocated for the current kind
+size_t temporalFilterBytes(const TemporalFilter &filter);
+
+#endif
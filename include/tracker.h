@@ -0,0 +1,53 @@
+#ifndef TRACKER_H
+#define TRACKER_H
+
+#include <stdint.h>
+#include "blobs.h"
+
+// Follows people (blobs) across frames: each frame the blobs are matched to the
+// predicted track positions by centroid distance, closest pairs first. A track
+// is only counted once it was seen in confirmFrames frames in a row and is kept
+// for dropFrames missed frames, so a flickering blob neither adds nor loses a
+// person. All storage is fixed, nothing is allocated.
+
+#define TRACKER_MAX_TRACKS 8
+
+struct Track
+{
+    uint16_t id; // 0 = free slot
+    float row;
+    float col;
+    float velocityRow; // pixels per frame
+    float velocityCol;
+    uint8_t hits;   // consecutive matched frames, saturates
+    uint8_t misses; // consecutive missed frames
+    bool confirmed;
+    int8_t side; // -1 / 1 of the counting line, 0 while on it or without a line
+};
+
+struct TrackerConfig
+{
+    float maxDistance;    // largest centroid jump between frames, in pixels
+    uint8_t confirmFrames; // frames in a row before a track counts
+    uint8_t dropFrames;    // missed frames before a confirmed track is removed
+    float lineRow;         // counting line across the frame at this row, negative disables it
+    float lineMargin;      // a side only changes this far past the line
+};
+
+struct Tracker
+{
+    TrackerConfig config;
+    uint16_t nextId;
+    uint32_t lineIn;  // crossings towards higher rows
+    uint32_t lineOut; // crossings towards lower rows
+    Track tracks[TRACKER_MAX_TRACKS];
+};
+
+TrackerConfig trackerDefaults();
+void trackerInit(Tracker &tracker, const TrackerConfig &config);
+// people holds the blobs of this frame that count as a person
+void trackerUpdate(Tracker &tracker, const BlobList &people);
+// confirmed tracks, including those missed for less than dropFrames frames
+int trackerCount(const Tracker &tracker);
+
+#endif
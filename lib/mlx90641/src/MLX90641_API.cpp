@@ -16,7 +16,9 @@
  */
 #include "MLX90641_API.h"
 #include "MLX90641_I2C_Driver.h"
+#include "MLX90641_Stats.h"
 #include <math.h>
+#include <string.h>
 
 void ExtractVDDParameters(uint16_t *eeData, paramsMLX90641 *mlx90641);
 void ExtractPTATParameters(uint16_t *eeData, paramsMLX90641 *mlx90641);
@@ -32,10 +34,27 @@ void ExtractKtaPixelParameters(uint16_t *eeData, paramsMLX90641 *mlx90641);
 void ExtractKvPixelParameters(uint16_t *eeData, paramsMLX90641 *mlx90641);
 void ExtractCPParameters(uint16_t *eeData, paramsMLX90641 *mlx90641);
 int ExtractDeviatingPixels(uint16_t *eeData, paramsMLX90641 *mlx90641);
+#ifdef MLX90641_FIXED_POINT
+void ExtractFixedPointParameters(paramsMLX90641 *mlx90641);
+#endif
 int CheckEEPROMValid(uint16_t *eeData);
 int HammingDecode(uint16_t *eeData);
 int ValidateFrameData(uint16_t *frameData);
 int ValidateAuxData(uint16_t *auxData);
+void CalculateToFast(uint16_t *frameData, const paramsMLX90641 *params, const calibMLX90641 *calib, float emissivity,
+                     float tr, float *result, const MLX90641_Layout *layout, MLX90641_FrameStats *stats);
+
+// Worst case To error in K over -40..300C for 1, 2 and 3 Newton steps of the
+// fast fourth root (measured 3.7, 0.023 and 0.0002), with margin for the
+// single precision rounding in the rest of the loop
+static const float fastToErrorBound[3] = {4.3f, 0.028f, 0.0005f};
+static int8_t fastToIterations = 0;
+
+// Frame read planning, see MLX90641_SetReadGap and MLX90641_SetAuxRefresh
+static uint16_t readGapWords = MLX90641_ACQ_READ_GAP_WORDS;
+static uint8_t auxRefresh = 8;
+// Bumped on every write to the control register so acquisitions re-read it
+static uint16_t controlGeneration = 0;
 
 //------------------------------------------------------------------------------
 
@@ -53,130 +72,51 @@ int MLX90641_DumpEE(uint8_t slaveAddr, uint16_t *eeData)
 
 //------------------------------------------------------------------------------
 
+// Parity check masks of the EEPROM Hamming code, bit n of the syndrome is the
+// parity of the word under hammingMasks[n]
+static const uint16_t hammingMasks[5] = {0x0D5B, 0x166D, 0x278E, 0x47F0, 0xFFFF};
+
+// Bit to flip for each syndrome. Syndromes 16..31 (overall parity wrong) are a
+// single bit error; 1..15 mean two bits are wrong and cannot be corrected.
+static const uint16_t hammingCorrection[32] = {
+    0,       0,       0,       0,       0,       0,       0,       0,
+    0,       0,       0,       0,       0,       0,       0,       0,
+    1 << 15, 1 << 11, 1 << 12, 1 << 0,  1 << 13, 1 << 1,  1 << 2,  1 << 3,
+    1 << 14, 1 << 4,  1 << 5,  1 << 6,  1 << 7,  1 << 8,  1 << 9,  1 << 10};
+
+static inline uint16_t Parity16(uint16_t x)
+{
+    x ^= x >> 8;
+    x ^= x >> 4;
+    return (0x6996 >> (x & 0x0F)) & 1;
+}
+
 int HammingDecode(uint16_t *eeData)
 {
     int error = 0;
-    int16_t parity[5];
-    int8_t D[16];
-    int16_t check;
+    uint16_t check;
     uint16_t data;
-    uint16_t mask;
 
     for (int addr = 16; addr < 832; addr++)
     {
-        parity[0] = -1;
-        parity[1] = -1;
-        parity[2] = -1;
-        parity[3] = -1;
-        parity[4] = -1;
-
         data = eeData[addr];
 
-        mask = 1;
-        for (int i = 0; i < 16; i++)
-        {
-            D[i] = (data & mask) >> i;
-            mask = mask << 1;
-        }
-
-        parity[0] = D[0] ^ D[1] ^ D[3] ^ D[4] ^ D[6] ^ D[8] ^ D[10] ^ D[11];
-        parity[1] = D[0] ^ D[2] ^ D[3] ^ D[5] ^ D[6] ^ D[9] ^ D[10] ^ D[12];
-        parity[2] = D[1] ^ D[2] ^ D[3] ^ D[7] ^ D[8] ^ D[9] ^ D[10] ^ D[13];
-        parity[3] = D[4] ^ D[5] ^ D[6] ^ D[7] ^ D[8] ^ D[9] ^ D[10] ^ D[14];
-        parity[4] = D[0] ^ D[1] ^ D[2] ^ D[3] ^ D[4] ^ D[5] ^ D[6] ^ D[7] ^ D[8] ^ D[9] ^ D[10] ^ D[11] ^ D[12] ^
-                    D[13] ^ D[14] ^ D[15];
+        check = Parity16(data & hammingMasks[0]) | Parity16(data & hammingMasks[1]) << 1 |
+                Parity16(data & hammingMasks[2]) << 2 | Parity16(data & hammingMasks[3]) << 3 |
+                Parity16(data & hammingMasks[4]) << 4;
 
-        if ((parity[0] != 0) || (parity[1] != 0) || (parity[2] != 0) || (parity[3] != 0) || (parity[4] != 0))
+        if (check > 15)
         {
-            check = (parity[0] << 0) + (parity[1] << 1) + (parity[2] << 2) + (parity[3] << 3) + (parity[4] << 4);
-
-            if ((check > 15) && (check < 32))
-            {
-                switch (check)
-                {
-                case 16:
-                    D[15] = 1 - D[15];
-                    break;
-
-                case 24:
-                    D[14] = 1 - D[14];
-                    break;
-
-                case 20:
-                    D[13] = 1 - D[13];
-                    break;
-
-                case 18:
-                    D[12] = 1 - D[12];
-                    break;
-
-                case 17:
-                    D[11] = 1 - D[11];
-                    break;
-
-                case 31:
-                    D[10] = 1 - D[10];
-                    break;
-
-                case 30:
-                    D[9] = 1 - D[9];
-                    break;
-
-                case 29:
-                    D[8] = 1 - D[8];
-                    break;
-
-                case 28:
-                    D[7] = 1 - D[7];
-                    break;
-
-                case 27:
-                    D[6] = 1 - D[6];
-                    break;
-
-                case 26:
-                    D[5] = 1 - D[5];
-                    break;
-
-                case 25:
-                    D[4] = 1 - D[4];
-                    break;
-
-                case 23:
-                    D[3] = 1 - D[3];
-                    break;
-
-                case 22:
-                    D[2] = 1 - D[2];
-                    break;
-
-                case 21:
-                    D[1] = 1 - D[1];
-                    break;
-
-                case 19:
-                    D[0] = 1 - D[0];
-                    break;
-                }
-
-                if (error == 0)
-                {
-                    error = -9;
-                }
-
-                data = 0;
-                mask = 1;
-                for (int i = 0; i < 16; i++)
-                {
-                    data = data + D[i] * mask;
-                    mask = mask << 1;
-                }
-            }
-            else
+            data ^= hammingCorrection[check];
+            if (error == 0)
             {
-                error = -10;
+                error = -9;
             }
         }
+        else if (check != 0)
+        {
+            error = -10;
+        }
 
         eeData[addr] = data & 0x07FF;
     }
@@ -227,6 +167,7 @@ int MLX90641_TriggerMeasurement(uint8_t slaveAddr)
 
     ctrlReg |= 0x8000;
     error = MLX90641_I2CWrite(slaveAddr, 0x800D, ctrlReg);
+    controlGeneration++;
 
     if (error != 0)
     {
@@ -259,132 +200,259 @@ int MLX90641_TriggerMeasurement(uint8_t slaveAddr)
 
 int MLX90641_GetFrameData(uint8_t slaveAddr, uint16_t *frameData)
 {
-    uint16_t dataReady = 1;
-    uint16_t controlRegister1;
-    uint16_t statusRegister;
-    uint16_t data[48];
-    int error = 1;
-    uint8_t cnt = 0;
-    uint8_t subPage = 0;
+    MLX90641_Acquisition acq;
 
-    dataReady = 0;
-    while (dataReady == 0)
+    memset(&acq, 0, sizeof(acq));
+    MLX90641_StartFrameData(&acq, slaveAddr, frameData);
+    while (MLX90641_PollFrameData(&acq) == 0)
     {
-        error = MLX90641_I2CRead(slaveAddr, 0x8000, 1, &statusRegister);
-        if (error != 0)
-        {
-            return error;
-        }
-        dataReady = statusRegister & 0x0008;
     }
-    subPage = statusRegister & 0x0001;
 
-    error = MLX90641_I2CWrite(slaveAddr, 0x8000, 0x0030);
-    if (error == -1)
+    return MLX90641_CompleteFrameData(&acq);
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_StartFrameData(MLX90641_Acquisition *acq, uint8_t slaveAddr, uint16_t *frameData)
+{
+    acq->slaveAddr = slaveAddr;
+    acq->frameData = frameData;
+    acq->state = MLX90641_ACQ_WAIT_READY;
+    acq->error = 0;
+    acq->stepCount = 0;
+    acq->transfer = 0;
+    acq->transferCount = 0;
+    acq->statusPolls = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SetReadGap(uint16_t words)
+{
+    readGapWords = words;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SetAuxRefresh(uint8_t subPages)
+{
+    auxRefresh = subPages > 0 ? subPages : 1;
+}
+
+//------------------------------------------------------------------------------
+
+static void AddFrameRead(MLX90641_Acquisition *acq, uint16_t address, uint16_t count, uint16_t *data)
+{
+    MLX90641_ReadStep *step = &acq->steps[acq->stepCount++];
+
+    step->address = address;
+    step->count = count;
+    step->data = data;
+}
+
+//------------------------------------------------------------------------------
+
+// Each sub-page is stored in every other 32 word block of the RAM. Of the aux
+// block only ptatArt (0), CP (8), gain (10), ptat (32) and vdd (42) are used;
+// all but CP follow the die temperature and supply, so they are re-read every
+// auxRefresh sub-pages. The control register only changes when written.
+static void PlanFrameReads(MLX90641_Acquisition *acq)
+{
+    uint16_t limit;
+    uint16_t end;
+    uint16_t gap;
+    uint16_t span;
+    uint8_t first[MLX90641_ACQ_MAX_STEPS];
+
+    acq->stepCount = 0;
+    for (int block = 0; block < 6; block++)
     {
-        return error;
+        AddFrameRead(acq, 0x0400 + 0x0040 * block + 0x0020 * acq->subPage, 32, acq->frameData + 32 * block);
     }
 
-    if (subPage == 0)
+    acq->auxRefreshed = acq->auxValid == 0 || acq->auxAge + 1 >= auxRefresh;
+    if (acq->auxRefreshed)
     {
-        error = MLX90641_I2CRead(slaveAddr, 0x0400, 32, frameData);
-        if (error != 0)
-        {
-            return error;
-        }
-        error = MLX90641_I2CRead(slaveAddr, 0x0440, 32, frameData + 32);
-        if (error != 0)
+        AddFrameRead(acq, 0x0580, 11, acq->auxData);
+        AddFrameRead(acq, 0x05A0, 1, acq->auxData + 32);
+        AddFrameRead(acq, 0x05AA, 1, acq->auxData + 42);
+    }
+    else
+    {
+        AddFrameRead(acq, 0x0588, 1, acq->auxData + 8);
+    }
+
+    if (acq->controlValid == 0 || acq->controlGeneration != controlGeneration)
+    {
+        acq->controlGeneration = controlGeneration;
+        AddFrameRead(acq, 0x800D, 1, &acq->controlRegister1);
+    }
+
+    // Merge neighbouring ranges while the span fits one transfer. Going from
+    // the last range down needs as few transfers as going up, but keeps the aux
+    // ranges together instead of adding the first one to sub-page 1's last block.
+    limit = MLX90641_I2CGetTransferSize() / 2;
+    if (limit > MLX90641_ACQ_BUFFER_WORDS)
+    {
+        limit = MLX90641_ACQ_BUFFER_WORDS;
+    }
+    end = acq->steps[acq->stepCount - 1].address + acq->steps[acq->stepCount - 1].count;
+    for (int step = acq->stepCount - 2; step >= 0; step--)
+    {
+        gap = acq->steps[step + 1].address - (acq->steps[step].address + acq->steps[step].count);
+        span = end - acq->steps[step].address;
+        first[step + 1] = gap > readGapWords || span > limit;
+        if (first[step + 1])
         {
-            return error;
+            end = acq->steps[step].address + acq->steps[step].count;
         }
-        error = MLX90641_I2CRead(slaveAddr, 0x0480, 32, frameData + 64);
-        if (error != 0)
+    }
+    acq->transferCount = 0;
+    for (int step = 1; step < acq->stepCount; step++)
+    {
+        if (first[step])
         {
-            return error;
+            acq->transferLast[acq->transferCount++] = step - 1;
         }
-        error = MLX90641_I2CRead(slaveAddr, 0x04C0, 32, frameData + 96);
-        if (error != 0)
+    }
+    acq->transferLast[acq->transferCount++] = acq->stepCount - 1;
+}
+
+//------------------------------------------------------------------------------
+
+static void FinishFrameData(MLX90641_Acquisition *acq)
+{
+    uint16_t *frameData = acq->frameData;
+
+    frameData[240] = acq->controlRegister1;
+    frameData[241] = acq->subPage;
+    acq->controlValid = 1;
+
+    // Words that are not read stay zero in auxData and pass the validation
+    if (ValidateAuxData(acq->auxData) == 0)
+    {
+        for (int cnt = 0; cnt < 48; cnt++)
         {
-            return error;
+            frameData[cnt + 192] = acq->auxData[cnt];
         }
-        error = MLX90641_I2CRead(slaveAddr, 0x0500, 32, frameData + 128);
-        if (error != 0)
+        if (acq->auxRefreshed)
         {
-            return error;
+            acq->auxValid = 1;
+            acq->auxAge = 0;
         }
-        error = MLX90641_I2CRead(slaveAddr, 0x0540, 32, frameData + 160);
-        if (error != 0)
+        else
         {
-            return error;
+            acq->auxAge++;
         }
     }
     else
     {
-        error = MLX90641_I2CRead(slaveAddr, 0x0420, 32, frameData);
+        acq->auxValid = 0;
+    }
+
+    acq->error = ValidateFrameData(frameData);
+}
+
+//------------------------------------------------------------------------------
+
+int MLX90641_PollFrameData(MLX90641_Acquisition *acq)
+{
+    uint16_t statusRegister;
+    MLX90641_ReadStep *first;
+    MLX90641_ReadStep *last;
+    int error;
+
+    switch (acq->state)
+    {
+    case MLX90641_ACQ_WAIT_READY:
+        error = MLX90641_I2CRead(acq->slaveAddr, 0x8000, 1, &statusRegister);
+        acq->statusPolls++;
         if (error != 0)
         {
-            return error;
+            acq->error = error;
+            acq->state = MLX90641_ACQ_DONE;
+            return 1;
         }
-        error = MLX90641_I2CRead(slaveAddr, 0x0460, 32, frameData + 32);
-        if (error != 0)
+        if ((statusRegister & 0x0008) == 0)
         {
-            return error;
+            return 0;
         }
-        error = MLX90641_I2CRead(slaveAddr, 0x04A0, 32, frameData + 64);
-        if (error != 0)
+        acq->subPage = statusRegister & 0x0001;
+        acq->state = MLX90641_ACQ_CLEAR_READY;
+        return 0;
+
+    case MLX90641_ACQ_CLEAR_READY:
+        error = MLX90641_I2CWrite(acq->slaveAddr, 0x8000, 0x0030);
+        if (error == -1)
         {
-            return error;
+            acq->error = error;
+            acq->state = MLX90641_ACQ_DONE;
+            return 1;
         }
-        error = MLX90641_I2CRead(slaveAddr, 0x04E0, 32, frameData + 96);
-        if (error != 0)
+
+        PlanFrameReads(acq);
+        acq->state = MLX90641_ACQ_READ;
+        return 0;
+
+    case MLX90641_ACQ_READ:
+        first = &acq->steps[acq->transfer == 0 ? 0 : acq->transferLast[acq->transfer - 1] + 1];
+        last = &acq->steps[acq->transferLast[acq->transfer]];
+        if (first == last)
         {
-            return error;
+            error = MLX90641_I2CRead(acq->slaveAddr, first->address, first->count, first->data);
         }
-        error = MLX90641_I2CRead(slaveAddr, 0x0520, 32, frameData + 128);
-        if (error != 0)
+        else
         {
-            return error;
+            error = MLX90641_I2CRead(acq->slaveAddr, first->address, last->address + last->count - first->address,
+                                     acq->buffer);
+            for (MLX90641_ReadStep *step = first; step <= last && error == 0; step++)
+            {
+                memcpy(step->data, acq->buffer + (step->address - first->address), step->count * sizeof(uint16_t));
+            }
         }
-        error = MLX90641_I2CRead(slaveAddr, 0x0560, 32, frameData + 160);
         if (error != 0)
         {
-            return error;
+            acq->error = error;
+            acq->state = MLX90641_ACQ_DONE;
+            acq->auxValid = 0;
+            acq->controlValid = 0;
+            return 1;
+        }
+        acq->transfer++;
+        if (acq->transfer < acq->transferCount)
+        {
+            return 0;
         }
-    }
-
-    error = MLX90641_I2CRead(slaveAddr, 0x0580, 48, data);
-    if (error != 0)
-    {
-        return error;
-    }
 
-    error = MLX90641_I2CRead(slaveAddr, 0x800D, 1, &controlRegister1);
-    frameData[240] = controlRegister1;
-    frameData[241] = subPage;
+        FinishFrameData(acq);
+        acq->state = MLX90641_ACQ_DONE;
+        return 1;
 
-    if (error != 0)
-    {
-        return error;
+    default:
+        return 1;
     }
+}
 
-    error = ValidateAuxData(data);
-    if (error == 0)
+//------------------------------------------------------------------------------
+
+int MLX90641_CompleteFrameData(MLX90641_Acquisition *acq)
+{
+    if (acq->state != MLX90641_ACQ_DONE)
     {
-        for (cnt = 0; cnt < 48; cnt++)
-        {
-            frameData[cnt + 192] = data[cnt];
-        }
+        return -1;
     }
 
-    error = ValidateFrameData(frameData);
-    if (error != 0)
+    acq->state = MLX90641_ACQ_IDLE;
+    if (acq->error != 0)
     {
-        return error;
+        return acq->error;
     }
 
-    return frameData[241];
+    return acq->subPage;
 }
 
+//------------------------------------------------------------------------------
+
 int ValidateFrameData(uint16_t *frameData)
 {
     uint8_t line = 0;
@@ -454,6 +522,9 @@ int MLX90641_ExtractParameters(uint16_t *eeData, paramsMLX90641 *mlx90641)
         ExtractKtaPixelParameters(eeData, mlx90641);
         ExtractKvPixelParameters(eeData, mlx90641);
         error = ExtractDeviatingPixels(eeData, mlx90641);
+#ifdef MLX90641_FIXED_POINT
+        ExtractFixedPointParameters(mlx90641);
+#endif
     }
 
     return error;
@@ -475,6 +546,7 @@ int MLX90641_SetResolution(uint8_t slaveAddr, uint8_t resolution)
     {
         value = (controlRegister1 & 0xF3FF) | value;
         error = MLX90641_I2CWrite(slaveAddr, 0x800D, value);
+        controlGeneration++;
     }
 
     return error;
@@ -513,6 +585,7 @@ int MLX90641_SetRefreshRate(uint8_t slaveAddr, uint8_t refreshRate)
     {
         value = (controlRegister1 & 0xFC7F) | value;
         error = MLX90641_I2CWrite(slaveAddr, 0x800D, value);
+        controlGeneration++;
     }
 
     return error;
@@ -674,6 +747,380 @@ void MLX90641_CalculateTo(uint16_t *frameData, const paramsMLX90641 *params, flo
 
 //------------------------------------------------------------------------------
 
+void MLX90641_CompileParameters(const paramsMLX90641 *params, calibMLX90641 *calib)
+{
+    float ktaScale;
+    float kvScale;
+    float alphaScale;
+
+    // Same expressions as MLX90641_CalculateTo, evaluated once instead of per frame,
+    // so MLX90641_CalculateToCompiled produces bit-identical results.
+    ktaScale = pow(2, (double)params->ktaScale);
+    kvScale = pow(2, (double)params->kvScale);
+    alphaScale = pow(2, (double)params->alphaScale);
+
+    for (int pixelNumber = 0; pixelNumber < 192; pixelNumber++)
+    {
+        calib->offset[0][pixelNumber] = params->offset[0][pixelNumber];
+        calib->offset[1][pixelNumber] = params->offset[1][pixelNumber];
+        calib->kta[pixelNumber] = (float)params->kta[pixelNumber] / ktaScale;
+        calib->kv[pixelNumber] = (float)params->kv[pixelNumber] / kvScale;
+        calib->alpha[pixelNumber] = SCALEALPHA * alphaScale / params->alpha[pixelNumber];
+    }
+
+    calib->ktaScale = params->ktaScale;
+    calib->kvScale = params->kvScale;
+    calib->alphaScale = params->alphaScale;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_DecompileParameters(const calibMLX90641 *calib, paramsMLX90641 *params)
+{
+    float ktaScale;
+    float kvScale;
+    float alphaScale;
+
+    ktaScale = pow(2, (double)calib->ktaScale);
+    kvScale = pow(2, (double)calib->kvScale);
+    alphaScale = pow(2, (double)calib->alphaScale);
+
+    // kta, kv and offset lanes hold exact values; alpha is rounded back to the
+    // nearest integer, which recovers the original 16-bit value.
+    for (int pixelNumber = 0; pixelNumber < 192; pixelNumber++)
+    {
+        params->offset[0][pixelNumber] = calib->offset[0][pixelNumber];
+        params->offset[1][pixelNumber] = calib->offset[1][pixelNumber];
+        params->kta[pixelNumber] = calib->kta[pixelNumber] * ktaScale;
+        params->kv[pixelNumber] = calib->kv[pixelNumber] * kvScale;
+        params->alpha[pixelNumber] = SCALEALPHA * alphaScale / calib->alpha[pixelNumber] + 0.5;
+    }
+
+    params->ktaScale = calib->ktaScale;
+    params->kvScale = calib->kvScale;
+    params->alphaScale = calib->alphaScale;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_CalculateToCompiled(uint16_t *frameData, const paramsMLX90641 *params, const calibMLX90641 *calib,
+                                  float emissivity, float tr, float *result, const MLX90641_Layout *layout,
+                                  MLX90641_FrameStats *stats)
+{
+    float vdd;
+    float ta;
+    float ta4;
+    float tr4;
+    float taTr;
+    float gain;
+    float irDataCP;
+    float irData;
+    float alphaCompensated;
+    float Sx;
+    float To;
+    float alphaCorrR[8];
+    int8_t range;
+    uint16_t subPage;
+
+    if (fastToIterations > 0)
+    {
+        CalculateToFast(frameData, params, calib, emissivity, tr, result, layout, stats);
+        return;
+    }
+    if (stats != NULL)
+    {
+        MLX90641_FrameStatsReset(stats);
+    }
+
+    subPage = frameData[241];
+    vdd = MLX90641_GetVdd(frameData, params);
+    ta = MLX90641_GetTa(frameData, params);
+    ta4 = (ta + 273.15);
+    ta4 = ta4 * ta4;
+    ta4 = ta4 * ta4;
+    tr4 = (tr + 273.15);
+    tr4 = tr4 * tr4;
+    tr4 = tr4 * tr4;
+
+    taTr = tr4 - (tr4 - ta4) / emissivity;
+
+    alphaCorrR[1] = 1 / (1 + params->ksTo[1] * 20);
+    alphaCorrR[0] = alphaCorrR[1] / (1 + params->ksTo[0] * 20);
+    alphaCorrR[2] = 1;
+    alphaCorrR[3] = (1 + params->ksTo[2] * params->ct[3]);
+    alphaCorrR[4] = alphaCorrR[3] * (1 + params->ksTo[3] * (params->ct[4] - params->ct[3]));
+    alphaCorrR[5] = alphaCorrR[4] * (1 + params->ksTo[4] * (params->ct[5] - params->ct[4]));
+    alphaCorrR[6] = alphaCorrR[5] * (1 + params->ksTo[5] * (params->ct[6] - params->ct[5]));
+    alphaCorrR[7] = alphaCorrR[6] * (1 + params->ksTo[6] * (params->ct[7] - params->ct[6]));
+
+    //------------------------- Gain calculation -----------------------------------
+    gain = frameData[202];
+    if (gain > 32767)
+    {
+        gain = gain - 65536;
+    }
+
+    gain = params->gainEE / gain;
+
+    //------------------------- To calculation -------------------------------------
+    irDataCP = frameData[200];
+    if (irDataCP > 32767)
+    {
+        irDataCP = irDataCP - 65536;
+    }
+    irDataCP = irDataCP * gain;
+
+    irDataCP = irDataCP - params->cpOffset * (1 + params->cpKta * (ta - 25)) * (1 + params->cpKv * (vdd - 3.3));
+
+    for (int pixelNumber = 0; pixelNumber < 192; pixelNumber++)
+    {
+        irData = frameData[pixelNumber];
+        if (irData > 32767)
+        {
+            irData = irData - 65536;
+        }
+        irData = irData * gain;
+
+        irData = irData - calib->offset[subPage][pixelNumber] * (1 + calib->kta[pixelNumber] * (ta - 25)) *
+                              (1 + calib->kv[pixelNumber] * (vdd - 3.3));
+
+        irData = irData - params->tgc * irDataCP;
+
+        irData = irData / emissivity;
+
+        alphaCompensated = calib->alpha[pixelNumber];
+        alphaCompensated = alphaCompensated * (1 + params->KsTa * (ta - 25));
+
+        Sx = alphaCompensated * alphaCompensated * alphaCompensated * (irData + alphaCompensated * taTr);
+        Sx = sqrt(sqrt(Sx)) * params->ksTo[2];
+
+        To = sqrt(sqrt(irData / (alphaCompensated * (1 - params->ksTo[2] * 273.15) + Sx) + taTr)) - 273.15;
+
+        if (To < params->ct[1])
+        {
+            range = 0;
+        }
+        else if (To < params->ct[2])
+        {
+            range = 1;
+        }
+        else if (To < params->ct[3])
+        {
+            range = 2;
+        }
+        else if (To < params->ct[4])
+        {
+            range = 3;
+        }
+        else if (To < params->ct[5])
+        {
+            range = 4;
+        }
+        else if (To < params->ct[6])
+        {
+            range = 5;
+        }
+        else if (To < params->ct[7])
+        {
+            range = 6;
+        }
+        else
+        {
+            range = 7;
+        }
+
+        To = sqrt(sqrt(irData / (alphaCompensated * alphaCorrR[range] *
+                                 (1 + params->ksTo[range] * (To - params->ct[range]))) +
+                       taTr)) -
+             273.15;
+
+        result[MLX90641_LayoutOffset(layout, pixelNumber)] = To;
+        if (stats != NULL)
+        {
+            FrameStatsAddFloat(stats, pixelNumber, To);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SetFastTo(float maxError)
+{
+    fastToIterations = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        if (maxError >= fastToErrorBound[i])
+        {
+            fastToIterations = i + 1;
+            break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+float MLX90641_GetFastToError(void)
+{
+    if (fastToIterations == 0)
+    {
+        return 0;
+    }
+    return fastToErrorBound[fastToIterations - 1];
+}
+
+//------------------------------------------------------------------------------
+
+float MLX90641_FastFourthRoot(float x)
+{
+    uint32_t bits;
+    float r;
+    float r2;
+
+    if (!(x > 0))
+    {
+        return sqrtf(x);
+    }
+
+    // Bit level estimate of x^-1/4, refined by Newton steps r = r * (1.25 - x * r^4 / 4),
+    // then x^1/4 = x * r^3. Float multiplies only, no divide and no sqrt.
+    memcpy(&bits, &x, sizeof(bits));
+    bits = 0x4F583000 - (bits >> 2);
+    memcpy(&r, &bits, sizeof(r));
+
+    for (int i = 0; i < fastToIterations; i++)
+    {
+        r2 = r * r;
+        r = r * (1.25f - 0.25f * x * r2 * r2);
+    }
+
+    return x * r * r * r;
+}
+
+//------------------------------------------------------------------------------
+
+void CalculateToFast(uint16_t *frameData, const paramsMLX90641 *params, const calibMLX90641 *calib, float emissivity,
+                     float tr, float *result, const MLX90641_Layout *layout, MLX90641_FrameStats *stats)
+{
+    float vdd;
+    float ta;
+    float ta4;
+    float tr4;
+    float taTr;
+    float gain;
+    float irDataCP;
+    float irData;
+    float alphaCompensated;
+    float Sx;
+    float To;
+    float alphaCorrR[8];
+    int8_t range;
+    uint16_t subPage;
+
+    // MLX90641_CalculateToCompiled in single precision throughout
+    if (stats != NULL)
+    {
+        MLX90641_FrameStatsReset(stats);
+    }
+    subPage = frameData[241];
+    vdd = MLX90641_GetVdd(frameData, params);
+    ta = MLX90641_GetTa(frameData, params);
+    ta4 = (ta + 273.15f);
+    ta4 = ta4 * ta4;
+    ta4 = ta4 * ta4;
+    tr4 = (tr + 273.15f);
+    tr4 = tr4 * tr4;
+    tr4 = tr4 * tr4;
+
+    taTr = tr4 - (tr4 - ta4) / emissivity;
+
+    alphaCorrR[1] = 1 / (1 + params->ksTo[1] * 20);
+    alphaCorrR[0] = alphaCorrR[1] / (1 + params->ksTo[0] * 20);
+    alphaCorrR[2] = 1;
+    alphaCorrR[3] = (1 + params->ksTo[2] * params->ct[3]);
+    alphaCorrR[4] = alphaCorrR[3] * (1 + params->ksTo[3] * (params->ct[4] - params->ct[3]));
+    alphaCorrR[5] = alphaCorrR[4] * (1 + params->ksTo[4] * (params->ct[5] - params->ct[4]));
+    alphaCorrR[6] = alphaCorrR[5] * (1 + params->ksTo[5] * (params->ct[6] - params->ct[5]));
+    alphaCorrR[7] = alphaCorrR[6] * (1 + params->ksTo[6] * (params->ct[7] - params->ct[6]));
+
+    //------------------------- Gain calculation -----------------------------------
+    gain = (int16_t)frameData[202];
+    gain = params->gainEE / gain;
+
+    //------------------------- To calculation -------------------------------------
+    irDataCP = (int16_t)frameData[200];
+    irDataCP = irDataCP * gain;
+
+    irDataCP = irDataCP - params->cpOffset * (1 + params->cpKta * (ta - 25)) * (1 + params->cpKv * (vdd - 3.3f));
+
+    const float ktaTerm = ta - 25;
+    const float kvTerm = vdd - 3.3f;
+    const float tgcTerm = params->tgc * irDataCP;
+    const float ksTaTerm = 1 + params->KsTa * (ta - 25);
+    const float ksTo2Term = 1 - params->ksTo[2] * 273.15f;
+
+    for (int pixelNumber = 0; pixelNumber < 192; pixelNumber++)
+    {
+        irData = (int16_t)frameData[pixelNumber];
+        irData = irData * gain;
+
+        irData = irData - calib->offset[subPage][pixelNumber] * (1 + calib->kta[pixelNumber] * ktaTerm) *
+                              (1 + calib->kv[pixelNumber] * kvTerm);
+
+        irData = irData - tgcTerm;
+
+        irData = irData / emissivity;
+
+        alphaCompensated = calib->alpha[pixelNumber] * ksTaTerm;
+
+        Sx = alphaCompensated * alphaCompensated * alphaCompensated * (irData + alphaCompensated * taTr);
+        Sx = MLX90641_FastFourthRoot(Sx) * params->ksTo[2];
+
+        To = MLX90641_FastFourthRoot(irData / (alphaCompensated * ksTo2Term + Sx) + taTr) - 273.15f;
+
+        range = 0;
+        while (range < 7 && To >= params->ct[range + 1])
+        {
+            range++;
+        }
+
+        To = MLX90641_FastFourthRoot(irData / (alphaCompensated * alphaCorrR[range] *
+                                               (1 + params->ksTo[range] * (To - params->ct[range]))) +
+                                     taTr) -
+             273.15f;
+
+        result[MLX90641_LayoutOffset(layout, pixelNumber)] = To;
+        if (stats != NULL)
+        {
+            FrameStatsAddFloat(stats, pixelNumber, To);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_FrameStatsInit(MLX90641_FrameStats *stats, int16_t histogramLow, uint16_t histogramWidth)
+{
+    stats->histogramLow = histogramLow;
+    stats->histogramWidth = histogramWidth > 0 ? histogramWidth : 1;
+    MLX90641_FrameStatsReset(stats);
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_FrameStatsReset(MLX90641_FrameStats *stats)
+{
+    stats->count = 0;
+    stats->min = 0;
+    stats->max = 0;
+    stats->argMin = 0;
+    stats->argMax = 0;
+    stats->sum = 0;
+    stats->sumSquares = 0;
+    memset(stats->histogram, 0, sizeof(stats->histogram));
+}
+
+//------------------------------------------------------------------------------
+
 void MLX90641_GetImage(uint16_t *frameData, const paramsMLX90641 *params, float *result)
 {
     float vdd;
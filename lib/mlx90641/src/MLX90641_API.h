@@ -21,9 +21,29 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define SCALEALPHA 0.000001
+#define MLX90641_CALIB_ALIGN 32
+
+#ifdef MLX90641_FIXED_POINT
+// Scalar calibration in fixed point for the integer To path, filled in by
+// MLX90641_ExtractParameters. QN means the value is scaled by 2^N; the per
+// pixel tables (offset, kta, kv, alpha) are already integers.
+typedef struct
+{
+    int16_t KvPTAT;        // Q12
+    int16_t KtPTAT;        // Q3
+    uint16_t alphaPTAT;    // Q7
+    int16_t tgc;           // Q6
+    int16_t KsTa;          // Q15
+    int32_t cpKta;         // Q24
+    int32_t cpKv;          // Q24
+    int32_t ksTo[8];              // Q30
+    int32_t alphaCorrRInverse[8]; // Q29, 1 / alphaCorrR of the float path
+} fixedMLX90641;
+#endif
 
 typedef struct
 {
@@ -53,17 +73,165 @@ typedef struct
     int16_t cpOffset;
     float emissivityEE;
     uint16_t brokenPixels[2];
+#ifdef MLX90641_FIXED_POINT
+    fixedMLX90641 fixed;
+#endif
 } paramsMLX90641;
 
+// Per-pixel calibration as float lanes, one offset lane per sub-page. Every lane
+// is 768 bytes, so with the struct aligned all lanes start on a 32-byte boundary.
+typedef struct
+{
+    float offset[2][192];
+    float kta[192];
+    float kv[192];
+    float alpha[192];
+    uint8_t ktaScale;
+    uint8_t kvScale;
+    uint8_t alphaScale;
+} __attribute__((aligned(MLX90641_CALIB_ALIGN))) calibMLX90641;
+
+// Statistics of one compensated frame, gathered by the To kernels while they
+// write the pixels. Temperatures are centi-degrees C (clamped to int16), pixel
+// indices are in sensor order and NaN pixels are left out. The histogram bins
+// are histogramWidth wide from histogramLow on; the first and last bin also
+// count everything beyond them.
+#define MLX90641_HISTOGRAM_BINS 16
+
+typedef struct
+{
+    int16_t histogramLow;
+    uint16_t histogramWidth;
+    uint16_t count;
+    int16_t min;
+    int16_t max;
+    uint8_t argMin;
+    uint8_t argMax;
+    int32_t sum;
+    int64_t sumSquares;
+    uint16_t histogram[MLX90641_HISTOGRAM_BINS];
+} MLX90641_FrameStats;
+
+// Where the To kernels put each pixel: sensor pixel n (row n / 16, column n % 16
+// of the 12x16 array) goes to result[row * rowStride + column * colStride].
+// NULL is sensor order, i.e. rowStride 16 and colStride 1.
+typedef struct
+{
+    int16_t rowStride;
+    int16_t colStride;
+} MLX90641_Layout;
+
+static inline int MLX90641_LayoutOffset(const MLX90641_Layout *layout, int pixelNumber)
+{
+    if (layout == NULL)
+    {
+        return pixelNumber;
+    }
+    return (pixelNumber >> 4) * layout->rowStride + (pixelNumber & 15) * layout->colStride;
+}
+
+// Non-blocking frame acquisition, one register access per step
+#define MLX90641_ACQ_IDLE 0
+#define MLX90641_ACQ_WAIT_READY 1
+#define MLX90641_ACQ_CLEAR_READY 2
+#define MLX90641_ACQ_READ 3
+#define MLX90641_ACQ_DONE 4
+#define MLX90641_ACQ_MAX_STEPS 10
+// Largest merged read; ranges that are fetched together go through this buffer
+#ifndef MLX90641_ACQ_BUFFER_WORDS
+#define MLX90641_ACQ_BUFFER_WORDS 64
+#endif
+// Default read gap: holes up to this many words are read through rather than
+// paying another transaction (header bytes, a driver call and a Poll). It
+// covers the 21 and 9 word holes of the aux block, so refreshing the aux
+// words is one 43 word read, while the 32 words of the other sub-page between
+// pixel blocks are still skipped.
+#ifndef MLX90641_ACQ_READ_GAP_WORDS
+#define MLX90641_ACQ_READ_GAP_WORDS 24
+#endif
+
+typedef struct
+{
+    uint16_t address;
+    uint16_t count;
+    uint16_t *data;
+} MLX90641_ReadStep;
+
+typedef struct
+{
+    uint8_t slaveAddr;
+    uint8_t state;
+    uint8_t subPage;
+    uint8_t stepCount;
+    uint8_t transfer;
+    uint8_t transferCount;
+    int error;
+    uint16_t *frameData;
+    uint16_t auxData[48];
+    uint16_t controlRegister1;
+    uint32_t statusPolls;
+    // Caches kept across acquisitions; the struct must start zeroed
+    uint8_t auxValid;
+    uint8_t auxAge;
+    uint8_t auxRefreshed;
+    uint8_t controlValid;
+    uint16_t controlGeneration;
+    MLX90641_ReadStep steps[MLX90641_ACQ_MAX_STEPS]; // register ranges in address order
+    uint8_t transferLast[MLX90641_ACQ_MAX_STEPS];     // last step fetched by each transfer
+    uint16_t buffer[MLX90641_ACQ_BUFFER_WORDS];
+} MLX90641_Acquisition;
+
 int MLX90641_DumpEE(uint8_t slaveAddr, uint16_t *eeData);
 int MLX90641_SynchFrame(uint8_t slaveAddr);
 int MLX90641_TriggerMeasurement(uint8_t slaveAddr);
 int MLX90641_GetFrameData(uint8_t slaveAddr, uint16_t *frameData);
+// Start arms the acquisition; every Poll does at most one register access: a
+// read (one transaction), or the write that clears the ready flag, which
+// MLX90641_I2CWrite follows with a verify read (two transactions). Poll
+// returns 0 while busy, 1 once done. Complete then returns what
+// MLX90641_GetFrameData would have: the sub-page number or a negative error.
+void MLX90641_StartFrameData(MLX90641_Acquisition *acq, uint8_t slaveAddr, uint16_t *frameData);
+int MLX90641_PollFrameData(MLX90641_Acquisition *acq);
+int MLX90641_CompleteFrameData(MLX90641_Acquisition *acq);
+// Register ranges at most this many words apart are fetched in one transaction
+// when the span fits the I2C transfer size (default MLX90641_ACQ_READ_GAP_WORDS,
+// 0 merges adjacent ranges only).
+void MLX90641_SetReadGap(uint16_t words);
+// Ta/Vdd/gain aux words are re-read every this many sub-pages (default 8, 1 = always)
+void MLX90641_SetAuxRefresh(uint8_t subPages);
 int MLX90641_ExtractParameters(uint16_t *eeData, paramsMLX90641 *mlx90641);
 float MLX90641_GetVdd(uint16_t *frameData, const paramsMLX90641 *params);
 float MLX90641_GetTa(uint16_t *frameData, const paramsMLX90641 *params);
 void MLX90641_GetImage(uint16_t *frameData, const paramsMLX90641 *params, float *result);
 void MLX90641_CalculateTo(uint16_t *frameData, const paramsMLX90641 *params, float emissivity, float tr, float *result);
+void MLX90641_CompileParameters(const paramsMLX90641 *params, calibMLX90641 *calib);
+void MLX90641_DecompileParameters(const calibMLX90641 *calib, paramsMLX90641 *params);
+// layout and stats may be NULL; stats is reset at the start of every call
+void MLX90641_CalculateToCompiled(uint16_t *frameData, const paramsMLX90641 *params, const calibMLX90641 *calib,
+                                  float emissivity, float tr, float *result, const MLX90641_Layout *layout,
+                                  MLX90641_FrameStats *stats);
+void MLX90641_CalculateToSimd(uint16_t *frameData, const paramsMLX90641 *params, const calibMLX90641 *calib,
+                              float emissivity, float tr, float *result, const MLX90641_Layout *layout,
+                              MLX90641_FrameStats *stats);
+void MLX90641_FrameStatsInit(MLX90641_FrameStats *stats, int16_t histogramLow, uint16_t histogramWidth);
+void MLX90641_FrameStatsReset(MLX90641_FrameStats *stats);
+const char *MLX90641_SimdName(void);
+// Opt-in single precision To path for MLX90641_CalculateToCompiled. Uses the
+// fewest Newton steps whose worst case error over -40..300C is within maxError
+// (K); 0 or a bound tighter than the approximation allows keeps the exact path.
+void MLX90641_SetFastTo(float maxError);
+float MLX90641_GetFastToError(void);
+float MLX90641_FastFourthRoot(float x);
+#ifdef MLX90641_FIXED_POINT
+// Integer only Vdd -> Ta -> To chain for targets without an FPU. Vdd is returned
+// in Q20 volts, Ta in Q16 C; emissivity is Q15, tr Q16 C and the result is in
+// centi-degrees C, clamped to the int16 range. Stays within 0.02C of
+// MLX90641_CalculateTo over -40..300C.
+int32_t MLX90641_GetVddQ(uint16_t *frameData, const paramsMLX90641 *params);
+int32_t MLX90641_GetTaQ(uint16_t *frameData, const paramsMLX90641 *params);
+void MLX90641_CalculateToQ(uint16_t *frameData, const paramsMLX90641 *params, uint16_t emissivity, int32_t tr,
+                           int16_t *result, const MLX90641_Layout *layout, MLX90641_FrameStats *stats);
+#endif
 int MLX90641_SetResolution(uint8_t slaveAddr, uint8_t resolution);
 int MLX90641_GetCurResolution(uint8_t slaveAddr);
 int MLX90641_SetRefreshRate(uint8_t slaveAddr, uint8_t refreshRate);
@@ -0,0 +1,458 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "MLX90641_Bench.h"
+#include "MLX90641_API.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+int HammingDecode(uint16_t *eeData);
+
+#define BENCH_FRAME_WORDS 242
+#define BENCH_EE_WORDS 832
+#define BENCH_FAST_TO_ERROR 0.03f
+// the fourth root sweep is 34000 steps of 0.01C on a host, 0.1C on a board
+#ifdef ARDUINO
+#define BENCH_ROOT_STEPS 3400
+#else
+#define BENCH_ROOT_STEPS 34000
+#endif
+#define BENCH_YIELD_STEPS 256
+
+#if defined(__XTENSA__)
+#define BENCH_PLATFORM "xtensa"
+#elif defined(__x86_64__) || defined(__i386__)
+#define BENCH_PLATFORM "x86"
+#elif defined(__aarch64__) || defined(__arm__)
+#define BENCH_PLATFORM "arm"
+#else
+#define BENCH_PLATFORM "unknown"
+#endif
+
+typedef struct
+{
+    const MLX90641_BenchCorpus *corpus;
+    uint16_t *eeWork;
+    uint16_t *eeDecoded;
+    paramsMLX90641 *params;
+    calibMLX90641 *calib;
+    float *result;
+    float *reference;
+    int16_t *resultQ;
+    volatile float sink;
+} BenchState;
+
+typedef struct
+{
+    const char *name;
+    const char *unit;
+    uint16_t pixels;
+    uint8_t perDump;
+    uint8_t validate;
+    uint8_t fastTo; // runs with MLX90641_SetFastTo(BENCH_FAST_TO_ERROR), otherwise exact
+    void (*run)(BenchState *state, int item);
+    void (*convert)(BenchState *state); // result to float for validation, outside the timing
+} BenchCase;
+
+//------------------------------------------------------------------------------
+
+static void BenchYield(void)
+{
+#ifdef ARDUINO
+    yield();
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+uint64_t MLX90641_BenchNowNs(void)
+{
+#ifdef ARDUINO
+    return (uint64_t)micros() * 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+uint64_t MLX90641_BenchCycles(void)
+{
+#if defined(__XTENSA__)
+    uint32_t ccount;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+    return ccount;
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+static const uint16_t *BenchFrame(BenchState *state, int item)
+{
+    return state->corpus->frames + (uint32_t)item * BENCH_FRAME_WORDS;
+}
+
+static void BenchHammingDecode(BenchState *state, int item)
+{
+    memcpy(state->eeWork, state->corpus->eeData + (uint32_t)item * BENCH_EE_WORDS, BENCH_EE_WORDS * sizeof(uint16_t));
+    state->sink = HammingDecode(state->eeWork);
+}
+
+static void BenchExtractParameters(BenchState *state, int item)
+{
+    state->sink = MLX90641_ExtractParameters(state->eeDecoded + (uint32_t)item * BENCH_EE_WORDS, state->params);
+}
+
+static void BenchCompileParameters(BenchState *state, int item)
+{
+    (void)item;
+    MLX90641_CompileParameters(state->params, state->calib);
+    state->sink = state->calib->alpha[0];
+}
+
+static void BenchGetVdd(BenchState *state, int item)
+{
+    state->sink = MLX90641_GetVdd((uint16_t *)BenchFrame(state, item), state->params);
+}
+
+static void BenchGetTa(BenchState *state, int item)
+{
+    state->sink = MLX90641_GetTa((uint16_t *)BenchFrame(state, item), state->params);
+}
+
+static void BenchGetImage(BenchState *state, int item)
+{
+    MLX90641_GetImage((uint16_t *)BenchFrame(state, item), state->params, state->result);
+    state->sink = state->result[0];
+}
+
+static void BenchCalculateTo(BenchState *state, int item)
+{
+    MLX90641_CalculateTo((uint16_t *)BenchFrame(state, item), state->params, 0.95f, 17.0f, state->result);
+    state->sink = state->result[0];
+}
+
+static void BenchCalculateToCompiled(BenchState *state, int item)
+{
+    MLX90641_CalculateToCompiled((uint16_t *)BenchFrame(state, item), state->params, state->calib, 0.95f, 17.0f,
+                                 state->result, NULL, NULL);
+    state->sink = state->result[0];
+}
+
+static void BenchCalculateToStats(BenchState *state, int item)
+{
+    MLX90641_FrameStats stats;
+
+    MLX90641_FrameStatsInit(&stats, 1000, 200);
+    MLX90641_CalculateToCompiled((uint16_t *)BenchFrame(state, item), state->params, state->calib, 0.95f, 17.0f,
+                                 state->result, NULL, &stats);
+    state->sink = state->result[0] + stats.sum;
+}
+
+static void BenchCalculateToSimd(BenchState *state, int item)
+{
+    MLX90641_CalculateToSimd((uint16_t *)BenchFrame(state, item), state->params, state->calib, 0.95f, 17.0f,
+                             state->result, NULL, NULL);
+    state->sink = state->result[0];
+}
+
+#ifdef MLX90641_FIXED_POINT
+static void BenchCalculateToQ(BenchState *state, int item)
+{
+    MLX90641_CalculateToQ((uint16_t *)BenchFrame(state, item), state->params, 31130, 17 << 16, state->resultQ, NULL,
+                          NULL);
+    state->sink = state->resultQ[0];
+}
+
+static void BenchConvertQ(BenchState *state)
+{
+    for (int i = 0; i < 192; i++)
+    {
+        state->result[i] = state->resultQ[i] * 0.01f;
+    }
+}
+#endif
+
+static void BenchBadPixelsCorrection(BenchState *state, int item)
+{
+    (void)item;
+    MLX90641_BadPixelsCorrection(state->params->brokenPixels, state->result, state->params);
+    state->sink = state->result[0];
+}
+
+static const BenchCase benchCases[] = {
+    {"HammingDecode", "dump", 0, 1, 0, 0, BenchHammingDecode, NULL},
+    {"MLX90641_ExtractParameters", "dump", 0, 1, 0, 0, BenchExtractParameters, NULL},
+    {"MLX90641_CompileParameters", "dump", 0, 1, 0, 0, BenchCompileParameters, NULL},
+    {"MLX90641_GetVdd", "frame", 0, 0, 0, 0, BenchGetVdd, NULL},
+    {"MLX90641_GetTa", "frame", 0, 0, 0, 0, BenchGetTa, NULL},
+    {"MLX90641_GetImage", "frame", 192, 0, 0, 0, BenchGetImage, NULL},
+    {"MLX90641_CalculateTo", "frame", 192, 0, 0, 0, BenchCalculateTo, NULL},
+    {"MLX90641_CalculateToCompiled", "frame", 192, 0, 1, 0, BenchCalculateToCompiled, NULL},
+    {"MLX90641_CalculateToCompiled_stats", "frame", 192, 0, 1, 0, BenchCalculateToStats, NULL},
+    {"MLX90641_CalculateToCompiled_fast", "frame", 192, 0, 1, 1, BenchCalculateToCompiled, NULL},
+    {"MLX90641_CalculateToSimd", "frame", 192, 0, 1, 0, BenchCalculateToSimd, NULL},
+#ifdef MLX90641_FIXED_POINT
+    {"MLX90641_CalculateToQ", "frame", 192, 0, 1, 0, BenchCalculateToQ, BenchConvertQ},
+#endif
+    {"MLX90641_BadPixelsCorrection", "frame", 192, 0, 0, 0, BenchBadPixelsCorrection, NULL},
+};
+
+//------------------------------------------------------------------------------
+
+// Largest deviation from MLX90641_CalculateTo over the whole frame corpus, infinite
+// where only one of them is NaN
+static float BenchMaxError(BenchState *state, const BenchCase *bench)
+{
+    float maxError = 0;
+
+    for (int item = 0; item < state->corpus->frameCount; item++)
+    {
+        MLX90641_CalculateTo((uint16_t *)BenchFrame(state, item), state->params, 0.95f, 17.0f, state->reference);
+        bench->run(state, item);
+        if (bench->convert != NULL)
+        {
+            bench->convert(state);
+        }
+        for (int i = 0; i < 192; i++)
+        {
+            float error = fabs(state->result[i] - state->reference[i]);
+            // a NaN on one side only is a mismatch, NaN on both agrees
+            if ((state->result[i] != state->result[i]) != (state->reference[i] != state->reference[i]))
+            {
+                error = INFINITY;
+            }
+            if (error > maxError)
+            {
+                maxError = error;
+            }
+        }
+        BenchYield();
+    }
+
+    return maxError;
+}
+
+//------------------------------------------------------------------------------
+
+// Accuracy of the fast fourth root at each error bound, swept over the sensor
+// range -40..300C in BENCH_ROOT_STEPS steps
+static int BenchFourthRoot(char *out, size_t outSize)
+{
+    static const float bounds[3] = {5.0f, 0.03f, 0.001f};
+    const float stepSize = 340.0f / BENCH_ROOT_STEPS;
+    int length = 0;
+
+    length += snprintf(out, outSize, ",\"fourth_root\":[");
+    for (int b = 0; b < 3; b++)
+    {
+        float maxError = 0;
+
+        MLX90641_SetFastTo(bounds[b]);
+        for (int step = 0; step <= BENCH_ROOT_STEPS; step++)
+        {
+            float T = -40 + step * stepSize;
+            float Tk = T + 273.15f;
+            float error = fabs(MLX90641_FastFourthRoot(Tk * Tk * Tk * Tk) - 273.15f - T);
+            if (error > maxError)
+            {
+                maxError = error;
+            }
+            if (step % BENCH_YIELD_STEPS == 0)
+            {
+                BenchYield();
+            }
+        }
+        length += snprintf(out + length, length < (int)outSize ? outSize - length : 0,
+                           "%s{\"bound\":%g,\"guaranteed\":%g,\"max_error\":%g}", b == 0 ? "" : ",", bounds[b],
+                           MLX90641_GetFastToError(), maxError);
+    }
+    length += snprintf(out + length, length < (int)outSize ? outSize - length : 0, "]");
+
+    return length;
+}
+
+//------------------------------------------------------------------------------
+
+int MLX90641_Bench(const MLX90641_BenchCorpus *corpus, char *out, size_t outSize)
+{
+    BenchState state;
+    calibMLX90641 *calibBlock = NULL;
+    float previousFastTo = MLX90641_GetFastToError();
+    int length;
+    int results = 0;
+    int error = 0;
+
+    if ((corpus->eeCount == 0 && corpus->params == NULL) || corpus->frameCount == 0 || corpus->iterations == 0)
+    {
+        return -1;
+    }
+
+    // The frame functions only read the parameters, so given ones are used in
+    // place; dumps need their own copies to extract into.
+    memset(&state, 0, sizeof(state));
+    state.corpus = corpus;
+    state.result = (float *)malloc(2 * 192 * sizeof(float) + 192 * sizeof(int16_t));
+    if (corpus->eeCount != 0)
+    {
+        state.eeWork = (uint16_t *)malloc((corpus->eeCount + 1) * BENCH_EE_WORDS * sizeof(uint16_t));
+        state.params = (paramsMLX90641 *)malloc(sizeof(paramsMLX90641));
+    }
+    else
+    {
+        state.params = (paramsMLX90641 *)corpus->params;
+    }
+    if (corpus->eeCount != 0 || corpus->calib == NULL)
+    {
+        calibBlock = (calibMLX90641 *)malloc(sizeof(calibMLX90641) + MLX90641_CALIB_ALIGN);
+        state.calib = (calibMLX90641 *)(((uintptr_t)calibBlock + MLX90641_CALIB_ALIGN - 1) &
+                                        ~(uintptr_t)(MLX90641_CALIB_ALIGN - 1));
+    }
+    else
+    {
+        state.calib = (calibMLX90641 *)corpus->calib;
+    }
+    if (state.result == NULL || state.params == NULL || (corpus->eeCount != 0 && state.eeWork == NULL) ||
+        (state.calib != corpus->calib && calibBlock == NULL))
+    {
+        free(state.result);
+        if (corpus->eeCount != 0)
+        {
+            free(state.eeWork);
+            free(state.params);
+        }
+        free(calibBlock);
+        return -1;
+    }
+    state.reference = state.result + 192;
+    state.resultQ = (int16_t *)(state.result + 2 * 192);
+
+    if (corpus->eeCount == 0)
+    {
+        if (calibBlock != NULL)
+        {
+            MLX90641_CompileParameters(state.params, state.calib);
+        }
+    }
+    else
+    {
+        state.eeDecoded = state.eeWork + BENCH_EE_WORDS;
+        memcpy(state.eeDecoded, corpus->eeData, corpus->eeCount * BENCH_EE_WORDS * sizeof(uint16_t));
+        for (int i = 0; i < corpus->eeCount; i++)
+        {
+            HammingDecode(state.eeDecoded + i * BENCH_EE_WORDS);
+        }
+    }
+    memset(state.result, 0, 2 * 192 * sizeof(float) + 192 * sizeof(int16_t));
+
+    length = snprintf(out, outSize,
+                      "{\"platform\":\"" BENCH_PLATFORM "\",\"simd\":\"%s\",\"iterations\":%u,\"dumps\":%u,\"frames\":%u,\"results\":[",
+                      MLX90641_SimdName(), corpus->iterations, corpus->eeCount, corpus->frameCount);
+
+    for (size_t c = 0; c < sizeof(benchCases) / sizeof(benchCases[0]); c++)
+    {
+        const BenchCase *bench = &benchCases[c];
+        int items = bench->perDump ? corpus->eeCount : corpus->frameCount;
+        uint32_t calls = (uint32_t)items * corpus->iterations;
+        uint64_t startNs;
+        uint64_t startCycles;
+        uint64_t ns;
+        uint64_t cycles;
+
+        if (items == 0)
+        {
+            continue;
+        }
+
+        MLX90641_SetFastTo(bench->fastTo ? BENCH_FAST_TO_ERROR : 0);
+        startCycles = MLX90641_BenchCycles();
+        startNs = MLX90641_BenchNowNs();
+        for (int i = 0; i < corpus->iterations; i++)
+        {
+            for (int item = 0; item < items; item++)
+            {
+                bench->run(&state, item);
+            }
+            BenchYield();
+        }
+        ns = MLX90641_BenchNowNs() - startNs;
+        cycles = MLX90641_BenchCycles() - startCycles;
+#if defined(__XTENSA__)
+        cycles = (uint32_t)cycles;
+#endif
+
+        // Frame functions all run against the parameters of the first dump
+        if (bench->perDump)
+        {
+            MLX90641_ExtractParameters(state.eeDecoded, state.params);
+            MLX90641_CompileParameters(state.params, state.calib);
+        }
+
+        double nsPerCall = (double)ns / calls;
+        length += snprintf(out + length, length < (int)outSize ? outSize - length : 0,
+                           "%s{\"name\":\"%s\",\"unit\":\"%s\",\"calls\":%lu,\"ns\":%.1f,\"ns_per_pixel\":%.2f,"
+                           "\"per_s\":%.1f,\"cycles\":%.0f",
+                           results++ == 0 ? "" : ",", bench->name, bench->unit, (unsigned long)calls, nsPerCall,
+                           bench->pixels ? nsPerCall / bench->pixels : 0.0, ns ? 1e9 / nsPerCall : 0.0,
+                           (double)cycles / calls);
+        if (bench->validate)
+        {
+            length += snprintf(out + length, length < (int)outSize ? outSize - length : 0, ",\"max_abs_error\":%g}",
+                               BenchMaxError(&state, bench));
+        }
+        else
+        {
+            length += snprintf(out + length, length < (int)outSize ? outSize - length : 0, "}");
+        }
+    }
+
+    length += snprintf(out + length, length < (int)outSize ? outSize - length : 0, "]");
+    length += BenchFourthRoot(out + length, length < (int)outSize ? outSize - length : 0);
+    length += snprintf(out + length, length < (int)outSize ? outSize - length : 0, "}");
+    if (length >= (int)outSize)
+    {
+        error = -1;
+    }
+    MLX90641_SetFastTo(previousFastTo);
+
+    free(state.result);
+    if (corpus->eeCount != 0)
+    {
+        free(state.eeWork);
+        free(state.params);
+    }
+    free(calibBlock);
+
+    return error == 0 ? length : error;
+}
@@ -0,0 +1,59 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef _MLX90641_BENCH_H_
+#define _MLX90641_BENCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "MLX90641_API.h"
+
+// Recorded inputs for the benchmark: raw (Hamming encoded) EEPROM dumps of
+// 832 words and frameData records of 242 words as returned by GetFrameData.
+// Without dumps (eeCount 0) the dump functions are skipped and the frame
+// functions run against params, e.g. the ones already extracted at boot, and
+// against calib when it is given; nothing is copied then, so on a board only
+// the result buffers are allocated.
+typedef struct
+{
+    const uint16_t *eeData;
+    uint16_t eeCount;
+    const uint16_t *frames;
+    uint16_t frameCount;
+    uint16_t iterations;
+    const paramsMLX90641 *params;
+    const calibMLX90641 *calib;
+} MLX90641_BenchCorpus;
+
+// Writes one JSON object with a result per function: ns per call, ns per pixel,
+// calls per second and cycles per call (0 where there is no cycle counter).
+// Only the kernel calls are timed; mode switches and result conversions are
+// done outside the timed loops. On Arduino targets the loops yield() so a long
+// run from a web handler keeps the watchdog and WiFi fed.
+// Returns the length written or -1 if the buffer was too small.
+uint64_t MLX90641_BenchNowNs(void);
+uint64_t MLX90641_BenchCycles(void);
+int MLX90641_Bench(const MLX90641_BenchCorpus *corpus, char *out, size_t outSize);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "MLX90641_Cache.h"
+#include "MLX90641_I2C_Driver.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <LittleFS.h>
+
+static int FileRead(const char *path, uint32_t offset, void *data, uint16_t size)
+{
+    File file = LittleFS.open(path, "r");
+    int count;
+
+    if (!file)
+    {
+        return -1;
+    }
+    count = -1;
+    if (file.seek(offset))
+    {
+        count = file.read((uint8_t *)data, size);
+    }
+    file.close();
+
+    return count;
+}
+
+static int FileWrite(const char *path, const void *data, uint16_t size)
+{
+    File file = LittleFS.open(path, "w");
+    int count;
+
+    if (!file)
+    {
+        return -1;
+    }
+    count = file.write((const uint8_t *)data, size);
+    file.close();
+
+    return count;
+}
+#else
+#include <stdio.h>
+
+static int FileRead(const char *path, uint32_t offset, void *data, uint16_t size)
+{
+    FILE *file = fopen(path, "rb");
+    int count;
+
+    if (file == NULL)
+    {
+        return -1;
+    }
+    count = -1;
+    if (fseek(file, offset, SEEK_SET) == 0)
+    {
+        count = fread(data, 1, size, file);
+    }
+    fclose(file);
+
+    return count;
+}
+
+static int FileWrite(const char *path, const void *data, uint16_t size)
+{
+    FILE *file = fopen(path, "wb");
+    int count;
+
+    if (file == NULL)
+    {
+        return -1;
+    }
+    count = fwrite(data, 1, size, file);
+    if (fclose(file) != 0)
+    {
+        count = -1;
+    }
+
+    return count;
+}
+#endif
+
+static const MLX90641_Storage fileStorage = {FileRead, FileWrite};
+
+//------------------------------------------------------------------------------
+
+const MLX90641_Storage *MLX90641_FileStorage(void)
+{
+    return &fileStorage;
+}
+
+//------------------------------------------------------------------------------
+
+int MLX90641_ReadDeviceId(uint8_t slaveAddr, uint16_t *id)
+{
+    return MLX90641_I2CRead(slaveAddr, 0x2407, 3, id);
+}
+
+//------------------------------------------------------------------------------
+
+// CRC-32 (IEEE, reflected), bitwise to keep the table out of RAM
+static uint32_t Crc32(const void *data, uint32_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+
+//------------------------------------------------------------------------------
+
+int MLX90641_CacheLoad(const MLX90641_Storage *storage, const char *path, const uint16_t *id,
+                       paramsMLX90641 *params)
+{
+    MLX90641_CacheHeader header;
+
+    if (storage->read(path, 0, &header, sizeof(header)) != sizeof(header))
+    {
+        return -1;
+    }
+    if (header.magic != MLX90641_CACHE_MAGIC || header.version != MLX90641_CACHE_VERSION ||
+        header.size != sizeof(paramsMLX90641))
+    {
+        return -2;
+    }
+    if (memcmp(header.id, id, sizeof(header.id)) != 0)
+    {
+        return -3;
+    }
+
+    if (storage->read(path, sizeof(header), params, sizeof(paramsMLX90641)) != sizeof(paramsMLX90641) ||
+        Crc32(params, sizeof(paramsMLX90641)) != header.crc)
+    {
+        return -4;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+int MLX90641_CacheSave(const MLX90641_Storage *storage, const char *path, const uint16_t *id,
+                       const paramsMLX90641 *params)
+{
+    MLX90641_CacheHeader *header;
+    int size = sizeof(MLX90641_CacheHeader) + sizeof(paramsMLX90641);
+    int error = 0;
+
+    header = (MLX90641_CacheHeader *)malloc(size);
+    if (header == NULL)
+    {
+        return -1;
+    }
+
+    memset(header, 0, sizeof(MLX90641_CacheHeader));
+    header->magic = MLX90641_CACHE_MAGIC;
+    header->version = MLX90641_CACHE_VERSION;
+    header->size = sizeof(paramsMLX90641);
+    memcpy(header->id, id, sizeof(header->id));
+    header->crc = Crc32(params, sizeof(paramsMLX90641));
+    memcpy(header + 1, params, sizeof(paramsMLX90641));
+
+    if (storage->write(path, header, size) != size)
+    {
+        error = -1;
+    }
+    free(header);
+
+    return error;
+}
@@ -0,0 +1,67 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef _MLX90641_CACHE_H_
+#define _MLX90641_CACHE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "MLX90641_API.h"
+
+// Extracted parameters kept in flash so a warm boot can skip MLX90641_DumpEE and
+// MLX90641_ExtractParameters. An entry is only used when it was written by the
+// same layout (version and struct size) for the sensor with the same ID words
+// (EEPROM 0x2407-0x2409) and its CRC matches.
+
+#define MLX90641_CACHE_MAGIC 0x4331394D // "M91C"
+#define MLX90641_CACHE_VERSION 2
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint16_t id[3];
+    uint16_t reserved;
+    uint32_t crc;
+} MLX90641_CacheHeader;
+
+// File access: read returns the bytes read from offset, write replaces the
+// whole file and returns the bytes written; both return -1 on failure.
+typedef struct
+{
+    int (*read)(const char *path, uint32_t offset, void *data, uint16_t size);
+    int (*write)(const char *path, const void *data, uint16_t size);
+} MLX90641_Storage;
+
+// LittleFS on Arduino builds (mounted by the caller), stdio elsewhere
+const MLX90641_Storage *MLX90641_FileStorage(void);
+
+int MLX90641_ReadDeviceId(uint8_t slaveAddr, uint16_t *id);
+// 0 on a hit; on a miss params may be partly overwritten and must be extracted
+int MLX90641_CacheLoad(const MLX90641_Storage *storage, const char *path, const uint16_t *id,
+                       paramsMLX90641 *params);
+int MLX90641_CacheSave(const MLX90641_Storage *storage, const char *path, const uint16_t *id,
+                       const paramsMLX90641 *params);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
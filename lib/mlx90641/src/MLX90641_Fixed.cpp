@@ -0,0 +1,338 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "MLX90641_API.h"
+#include "MLX90641_Stats.h"
+
+#ifdef MLX90641_FIXED_POINT
+
+#include <math.h>
+
+// Temperatures inside the To chain are Kelvin in Q20 (up to ~2000K fits int32),
+// radiated power T^4 is plain K^4 in int64.
+#define KELVIN_Q20 286418534 // 273.15 * 2^20
+#define VDD_Q20 3460301      // 3.3 * 2^20
+#define FOURTH_POWER_MAX ((int64_t)1 << 39)
+
+void ExtractFixedPointParameters(paramsMLX90641 *mlx90641);
+
+//------------------------------------------------------------------------------
+
+static int32_t ToFixed(double value, int fractionBits)
+{
+    return (int32_t)lround(ldexp(value, fractionBits));
+}
+
+void ExtractFixedPointParameters(paramsMLX90641 *mlx90641)
+{
+    fixedMLX90641 *fixed = &mlx90641->fixed;
+    double alphaCorrR[8];
+
+    // All of these are EEPROM fields divided by a power of two, so the
+    // conversion is exact except for ksTo and cpKta/cpKv with very large scales.
+    fixed->KvPTAT = ToFixed(mlx90641->KvPTAT, 12);
+    fixed->KtPTAT = ToFixed(mlx90641->KtPTAT, 3);
+    fixed->alphaPTAT = ToFixed(mlx90641->alphaPTAT, 7);
+    fixed->tgc = ToFixed(mlx90641->tgc, 6);
+    fixed->KsTa = ToFixed(mlx90641->KsTa, 15);
+    fixed->cpKta = ToFixed(mlx90641->cpKta, 24);
+    fixed->cpKv = ToFixed(mlx90641->cpKv, 24);
+
+    alphaCorrR[1] = 1 / (1 + mlx90641->ksTo[1] * 20);
+    alphaCorrR[0] = alphaCorrR[1] / (1 + mlx90641->ksTo[0] * 20);
+    alphaCorrR[2] = 1;
+    alphaCorrR[3] = (1 + mlx90641->ksTo[2] * mlx90641->ct[3]);
+    for (int i = 4; i < 8; i++)
+    {
+        alphaCorrR[i] = alphaCorrR[i - 1] * (1 + mlx90641->ksTo[i - 1] * (mlx90641->ct[i] - mlx90641->ct[i - 1]));
+    }
+
+    // the To kernel multiplies by the inverse instead of dividing per pixel
+    for (int i = 0; i < 8; i++)
+    {
+        fixed->ksTo[i] = ToFixed(mlx90641->ksTo[i], 30);
+        fixed->alphaCorrRInverse[i] = ToFixed(1 / alphaCorrR[i], 29);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// 1 / sqrt(f) in Q15 at the middle of each 1/128 wide bucket of f in [0.25, 1)
+static const uint16_t rsqrtSeed[96] = {
+    65030, 64052, 63117, 62222, 61363, 60540, 59748, 58987, 58254, 57548, 56867, 56210,
+    55574, 54960, 54366, 53791, 53233, 52693, 52169, 51660, 51165, 50685, 50218, 49763,
+    49321, 48890, 48470, 48061, 47663, 47273, 46894, 46523, 46161, 45807, 45462, 45124,
+    44793, 44470, 44153, 43843, 43540, 43243, 42951, 42666, 42386, 42112, 41843, 41579,
+    41320, 41065, 40816, 40571, 40330, 40093, 39861, 39632, 39408, 39187, 38970, 38756,
+    38546, 38340, 38136, 37936, 37739, 37545, 37354, 37166, 36980, 36798, 36618, 36441,
+    36266, 36093, 35924, 35756, 35591, 35428, 35267, 35109, 34953, 34798, 34646, 34496,
+    34347, 34201, 34056, 33913, 33772, 33633, 33496, 33360, 33225, 33093, 32962, 32832,
+};
+
+// The top 32 bits of x, shifted by an even count, are a Q32 fraction f in
+// [0.25, 1). The table seeds 1 / sqrt(f) to 7 bits, two Newton steps
+// y = y * (3 - f * y^2) / 2 refine it to ~28 bits and sqrt(f) = f * y.
+// Multiplies only, no divide and no loop over the bits.
+static uint32_t Sqrt64(uint64_t x)
+{
+    uint64_t y;
+    uint64_t root;
+    uint32_t f;
+    int shift;
+
+    if (x == 0)
+    {
+        return 0;
+    }
+
+    shift = __builtin_clzll(x) & ~1;
+    f = (x << shift) >> 32;
+    y = (uint64_t)rsqrtSeed[(f >> 25) - 32] << 15; // Q30
+    for (int i = 0; i < 2; i++)
+    {
+        uint64_t fy2 = (f * ((y * y) >> 30)) >> 32;
+        y = (y * ((3ULL << 30) - fy2)) >> 31;
+    }
+
+    root = ((uint64_t)f * y) >> 30;
+    if (root > UINT32_MAX)
+    {
+        root = UINT32_MAX;
+    }
+    return root >> (shift >> 1);
+}
+
+//------------------------------------------------------------------------------
+
+// 1 / d for d in Q30 near 1: three Newton steps r = r * (2 - d * r) from
+// r = 2 - d, each squaring the relative error. |d - 1| is at most ksTo * 600K,
+// ~0.5 for the largest ksTo; d is clamped to that so the steps always converge.
+static int64_t ReciprocalQ30(int64_t d)
+{
+    const int64_t two = (int64_t)2 << 30;
+    int64_t r;
+
+    if (d < ((int64_t)1 << 29))
+    {
+        d = (int64_t)1 << 29;
+    }
+    else if (d > ((int64_t)3 << 29))
+    {
+        d = (int64_t)3 << 29;
+    }
+
+    r = two - d;
+    for (int i = 0; i < 3; i++)
+    {
+        r = (r * (two - ((d * r) >> 30))) >> 30;
+    }
+    return r;
+}
+
+//------------------------------------------------------------------------------
+
+// (u * r) >> 30 for |u| up to 2^40 without overflowing 64 bits
+static int64_t MulQ30(int64_t u, int64_t r)
+{
+    return (u >> 30) * r + (((u & ((1 << 30) - 1)) * r) >> 30);
+}
+
+//------------------------------------------------------------------------------
+
+// K^4 -> Kelvin Q20. The first root keeps T^2 in Q12, the second scales it up
+// again so the result keeps 20 fraction bits.
+static int32_t FourthRootQ20(int64_t x)
+{
+    uint64_t square;
+
+    if (x <= 0)
+    {
+        return 0;
+    }
+    if (x > FOURTH_POWER_MAX)
+    {
+        x = FOURTH_POWER_MAX;
+    }
+
+    square = Sqrt64((uint64_t)x << 24);
+    return Sqrt64(square << 28);
+}
+
+//------------------------------------------------------------------------------
+
+// Kelvin Q20 -> K^4
+static int64_t FourthPowerQ20(int32_t t)
+{
+    int64_t square;
+
+    square = ((int64_t)t * t) >> 32;
+    return (square * square) >> 16;
+}
+
+//------------------------------------------------------------------------------
+
+static int32_t GetDeltaVddQ20(uint16_t *frameData, const paramsMLX90641 *params)
+{
+    int64_t vdd;
+    int resolutionRAM;
+
+    // The resolution correction is a power of two between 2^-3 and 2^3, keep
+    // three fraction bits so it stays an integer shift.
+    resolutionRAM = (frameData[240] & 0x0C00) >> 10;
+    vdd = (int64_t)(int16_t)frameData[234] * (1 << (params->resolutionEE - resolutionRAM + 3));
+    vdd = vdd - (int64_t)params->vdd25 * 8;
+
+    return vdd * (1 << 17) / params->kVdd;
+}
+
+//------------------------------------------------------------------------------
+
+static int32_t GetTaQ16(uint16_t *frameData, const paramsMLX90641 *params, int32_t deltaVdd)
+{
+    int64_t ptat;
+    int64_t ptatArt;
+    int64_t ta;
+
+    ptat = (int16_t)frameData[224];
+    ptatArt = (int16_t)frameData[192];
+
+    // ptat / (ptat * alphaPTAT + ptatArt) * 2^18 in Q8
+    ptatArt = ptat * params->fixed.alphaPTAT + ptatArt * 128;
+    ptatArt = ptat * ((int64_t)1 << 33) / ptatArt;
+
+    ptatArt = ptatArt * (1 << 20) / ((1 << 20) + (((int64_t)params->fixed.KvPTAT * deltaVdd) >> 12));
+    ta = (ptatArt - (int64_t)params->vPTAT25 * 256) * 2048 / params->fixed.KtPTAT;
+
+    return ta + (25 << 16);
+}
+
+//------------------------------------------------------------------------------
+
+int32_t MLX90641_GetVddQ(uint16_t *frameData, const paramsMLX90641 *params)
+{
+    return GetDeltaVddQ20(frameData, params) + VDD_Q20;
+}
+
+//------------------------------------------------------------------------------
+
+int32_t MLX90641_GetTaQ(uint16_t *frameData, const paramsMLX90641 *params)
+{
+    return GetTaQ16(frameData, params, GetDeltaVddQ20(frameData, params));
+}
+
+//------------------------------------------------------------------------------
+
+// Same model as MLX90641_CalculateTo, rearranged to avoid the tiny alpha values:
+// with u = irData / alphaCompensated the first estimate is
+// To^4 = u / (1 + ksTo[2] * (T0 - 273.15)) + taTr where T0^4 = u + taTr.
+void MLX90641_CalculateToQ(uint16_t *frameData, const paramsMLX90641 *params, uint16_t emissivity, int32_t tr,
+                           int16_t *result, const MLX90641_Layout *layout, MLX90641_FrameStats *stats)
+{
+    const fixedMLX90641 *fixed = &params->fixed;
+    int32_t deltaVdd;
+    int32_t deltaTa;
+    int64_t ta4;
+    int64_t tr4;
+    int64_t taTr;
+    int32_t gain;
+    int32_t emissivityInverse;
+    int64_t alphaComp;
+    int64_t irDataCP;
+    int64_t irData;
+    int64_t kta;
+    int64_t kv;
+    int64_t u;
+    int64_t divisor;
+    int32_t To;
+    int8_t range;
+    uint16_t subPage;
+
+    if (stats != NULL)
+    {
+        MLX90641_FrameStatsReset(stats);
+    }
+    subPage = frameData[241];
+    gain = (int16_t)frameData[202];
+    if (gain == 0 || emissivity == 0)
+    {
+        return;
+    }
+
+    deltaVdd = GetDeltaVddQ20(frameData, params);
+    deltaTa = GetTaQ16(frameData, params, deltaVdd) - (25 << 16);
+
+    ta4 = FourthPowerQ20((deltaTa + (25 << 16)) * 16 + KELVIN_Q20);
+    tr4 = FourthPowerQ20(tr * 16 + KELVIN_Q20);
+    taTr = tr4 - (tr4 - ta4) * 32768 / emissivity;
+
+    gain = (int64_t)params->gainEE * 65536 / gain;
+    emissivityInverse = ((int64_t)1 << 31) / emissivity;
+
+    // 1 / (SCALEALPHA * (1 + KsTa * (ta - 25))) in Q8; the per pixel alpha table
+    // already holds 2^alphaScale / alpha.
+    alphaComp = ((int64_t)1000000 << 23) / ((1 << 15) + (((int64_t)fixed->KsTa * deltaTa) >> 16));
+
+    //------------------------- To calculation -------------------------------------
+    irDataCP = ((int64_t)(int16_t)frameData[200] * gain) >> 8;
+    kta = (1 << 24) + (((int64_t)fixed->cpKta * deltaTa) >> 16);
+    kv = (1 << 24) + (((int64_t)fixed->cpKv * deltaVdd) >> 20);
+    irDataCP = irDataCP - (((((int64_t)params->cpOffset * kta) >> 16) * kv) >> 24);
+    irDataCP = (irDataCP * fixed->tgc) >> 6;
+
+    for (int pixelNumber = 0; pixelNumber < 192; pixelNumber++)
+    {
+        irData = ((int64_t)(int16_t)frameData[pixelNumber] * gain) >> 8;
+
+        kta = (1 << 16) + ((params->kta[pixelNumber] * deltaTa) >> params->ktaScale);
+        kv = (1 << 16) + ((params->kv[pixelNumber] * deltaVdd) >> (params->kvScale + 4));
+        irData = irData - ((params->offset[subPage][pixelNumber] * kta * kv) >> 24);
+        irData = irData - irDataCP;
+        irData = (irData * emissivityInverse) >> 16;
+
+        u = (((irData * params->alpha[pixelNumber]) >> 10) * alphaComp) >> (6 + params->alphaScale);
+
+        To = FourthRootQ20(u + taTr);
+        divisor = (1 << 30) + (((int64_t)fixed->ksTo[2] * (To - KELVIN_Q20)) >> 20);
+        To = FourthRootQ20(MulQ30(u, ReciprocalQ30(divisor)) + taTr) - KELVIN_Q20;
+
+        range = 0;
+        while (range < 7 && To >= (int32_t)params->ct[range + 1] * (1 << 20))
+        {
+            range++;
+        }
+
+        divisor = (1 << 30) + (((int64_t)fixed->ksTo[range] * (To - (int32_t)params->ct[range] * (1 << 20))) >> 20);
+        divisor = (ReciprocalQ30(divisor) * fixed->alphaCorrRInverse[range]) >> 29;
+        To = FourthRootQ20(MulQ30(u, divisor) + taTr) - KELVIN_Q20;
+
+        To = ((int64_t)To * 100 + (1 << 19)) >> 20;
+        if (To > INT16_MAX)
+        {
+            To = INT16_MAX;
+        }
+        else if (To < INT16_MIN)
+        {
+            To = INT16_MIN;
+        }
+        result[MLX90641_LayoutOffset(layout, pixelNumber)] = To;
+        if (stats != NULL)
+        {
+            FrameStatsAdd(stats, pixelNumber, To);
+        }
+    }
+}
+
+#endif
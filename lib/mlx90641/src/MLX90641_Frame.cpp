@@ -0,0 +1,64 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "MLX90641_Frame.h"
+#include <string.h>
+
+void MLX90641_FrameInit(MLX90641_FrameAssembler *assembler, MLX90641_FrameCallback onFrame, void *context)
+{
+    memset(assembler, 0, sizeof(MLX90641_FrameAssembler));
+    assembler->onFrame = onFrame;
+    assembler->context = context;
+}
+
+//------------------------------------------------------------------------------
+
+// Drops the latest frame, e.g. after a resolution or refresh rate change
+void MLX90641_FrameReset(MLX90641_FrameAssembler *assembler)
+{
+    assembler->latest = NULL;
+}
+
+//------------------------------------------------------------------------------
+
+float *MLX90641_FrameBegin(MLX90641_FrameAssembler *assembler, const uint16_t *frameData)
+{
+    assembler->subPage = frameData[241] & 0x0001;
+
+    return assembler->to[assembler->next];
+}
+
+//------------------------------------------------------------------------------
+
+int MLX90641_FrameEnd(MLX90641_FrameAssembler *assembler)
+{
+    assembler->latest = assembler->to[assembler->next];
+    assembler->next ^= 1;
+    assembler->frames++;
+    if (assembler->onFrame != NULL)
+    {
+        assembler->onFrame(assembler->latest, assembler->subPage, assembler->context);
+    }
+
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+
+const float *MLX90641_FrameLatest(const MLX90641_FrameAssembler *assembler)
+{
+    return assembler->latest;
+}
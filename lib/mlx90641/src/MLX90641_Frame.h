@@ -0,0 +1,60 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef _MLX90641_FRAME_H_
+#define _MLX90641_FRAME_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Assembles displayed frames from sub-pages. Every MLX90641 sub-page already
+// carries all 192 pixels (with its own offset table), so each sub-page that
+// arrives is compensated exactly once and completes a frame on its own: one
+// read and one compensation per displayed frame instead of two. Completed
+// frames alternate between two slots whatever sub-page they came from, so the
+// values handed to the frame complete event stay intact while the next frame
+// is compensated into the other slot, i.e. until the frame after next starts.
+
+typedef void (*MLX90641_FrameCallback)(const float *to, uint8_t subPage, void *context);
+
+typedef struct
+{
+    float to[2][192];     // the two slots, filled alternately
+    const float *latest;  // slot completed last, NULL before the first frame
+    uint8_t next;         // slot filled between Begin and End
+    uint8_t subPage;      // sub-page being filled
+    uint32_t frames;      // frame complete events
+    MLX90641_FrameCallback onFrame;
+    void *context;
+} MLX90641_FrameAssembler;
+
+void MLX90641_FrameInit(MLX90641_FrameAssembler *assembler, MLX90641_FrameCallback onFrame, void *context);
+void MLX90641_FrameReset(MLX90641_FrameAssembler *assembler);
+// Returns the slot to compensate frameData into
+float *MLX90641_FrameBegin(MLX90641_FrameAssembler *assembler, const uint16_t *frameData);
+// Makes the slot the latest frame, raises the frame complete event and returns 1
+int MLX90641_FrameEnd(MLX90641_FrameAssembler *assembler);
+// Most recent compensated frame, NULL before the first sub-page is complete
+const float *MLX90641_FrameLatest(const MLX90641_FrameAssembler *assembler);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
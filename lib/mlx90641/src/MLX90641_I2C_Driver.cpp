@@ -16,10 +16,11 @@
  */
 #include "MLX90641_I2C_Driver.h"
 
+#ifdef ARDUINO
 #include <Arduino.h>
 #include <Wire.h>
 
-int MLX90641_I2CGeneralReset(void)
+static int WireGeneralReset(void)
 {
     Wire.beginTransmission(0);
     Wire.write(0x06);
@@ -30,7 +31,7 @@ int MLX90641_I2CGeneralReset(void)
     return 0;
 }
 
-int MLX90641_I2CRead(uint8_t slaveAddr, uint16_t startAddress, uint16_t nMemAddressRead, uint16_t *data)
+static int WireRead(uint8_t slaveAddr, uint16_t startAddress, uint16_t nMemAddressRead, uint16_t *data)
 {
     while (nMemAddressRead > 0)
     {
@@ -58,12 +59,7 @@ int MLX90641_I2CRead(uint8_t slaveAddr, uint16_t startAddress, uint16_t nMemAddr
     return 0;
 }
 
-void MLX90641_I2CFreqSet(int kHz)
-{
-    Wire.setClock(1000 * kHz);
-}
-
-int MLX90641_I2CWrite(uint8_t slaveAddr, uint16_t writeAddress, uint16_t data)
+static int WireWrite(uint8_t slaveAddr, uint16_t writeAddress, uint16_t data)
 {
     Wire.beginTransmission(slaveAddr);
     Wire.write(highByte(writeAddress));
@@ -77,6 +73,159 @@ int MLX90641_I2CWrite(uint8_t slaveAddr, uint16_t writeAddress, uint16_t data)
         return -1;
     }
 
+    return 0;
+}
+
+static void WireFreqSet(int kHz)
+{
+    Wire.setClock(1000 * kHz);
+}
+
+// ESP32 cores from 2.0 resize the Wire buffer at run time, elsewhere it is fixed
+// at build time (-D I2C_BUFFER_LENGTH=... on ESP8266 cores from 3.0).
+static uint16_t WireNegotiateTransfer(uint16_t bytes)
+{
+    size_t limit;
+
+#if defined(ESP32) && defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 2
+    limit = Wire.setBufferSize(bytes);
+    if (limit == 0)
+    {
+        limit = I2C_BUFFER_LENGTH;
+    }
+#elif defined(I2C_BUFFER_LENGTH)
+    limit = I2C_BUFFER_LENGTH;
+#elif defined(BUFFER_LENGTH)
+    limit = BUFFER_LENGTH;
+#else
+    limit = 32;
+#endif
+
+    return bytes < limit ? bytes : limit;
+}
+
+static const MLX90641_I2CBackend wireBackend = {WireGeneralReset, WireRead, WireWrite, WireFreqSet,
+                                                WireNegotiateTransfer};
+static const MLX90641_I2CBackend *backend = &wireBackend;
+#else
+static const MLX90641_I2CBackend *backend = 0;
+#endif
+
+static uint16_t transferWords = 0;
+static MLX90641_I2CStats stats;
+
+void MLX90641_I2CSetBackend(const MLX90641_I2CBackend *i2cBackend)
+{
+    backend = i2cBackend;
+    transferWords = 0;
+}
+
+const MLX90641_I2CBackend *MLX90641_I2CGetBackend(void)
+{
+    return backend;
+}
+
+int MLX90641_I2CGeneralReset(void)
+{
+    if (backend == 0)
+    {
+        return -1;
+    }
+    return backend->generalReset();
+}
+
+uint16_t MLX90641_I2CSetTransferSize(uint16_t bytes)
+{
+    if (backend == 0)
+    {
+        return 0;
+    }
+
+    transferWords = backend->negotiateTransfer(bytes) / 2;
+    if (transferWords == 0)
+    {
+        transferWords = 1;
+    }
+
+    return transferWords * 2;
+}
+
+uint16_t MLX90641_I2CGetTransferSize(void)
+{
+    if (transferWords == 0)
+    {
+        return MLX90641_I2CSetTransferSize(MLX90641_I2C_TRANSFER_BYTES);
+    }
+
+    return transferWords * 2;
+}
+
+void MLX90641_I2CGetStats(MLX90641_I2CStats *i2cStats)
+{
+    *i2cStats = stats;
+}
+
+void MLX90641_I2CResetStats(void)
+{
+    stats.transactions = 0;
+    stats.bytes = 0;
+}
+
+int MLX90641_I2CRead(uint8_t slaveAddr, uint16_t startAddress, uint16_t nMemAddressRead, uint16_t *data)
+{
+    uint16_t count;
+    int error;
+
+    if (backend == 0 || MLX90641_I2CGetTransferSize() == 0)
+    {
+        return -1;
+    }
+
+    while (nMemAddressRead > 0)
+    {
+        count = nMemAddressRead < transferWords ? nMemAddressRead : transferWords;
+        error = backend->read(slaveAddr, startAddress, count, data);
+        // address + register, repeated start address, data
+        stats.transactions++;
+        stats.bytes += 4 + 2 * count;
+        if (error != 0)
+        {
+            return error;
+        }
+
+        startAddress += count;
+        data += count;
+        nMemAddressRead -= count;
+    }
+
+    return 0;
+}
+
+void MLX90641_I2CFreqSet(int kHz)
+{
+    if (backend != 0)
+    {
+        backend->freqSet(kHz);
+    }
+}
+
+int MLX90641_I2CWrite(uint8_t slaveAddr, uint16_t writeAddress, uint16_t data)
+{
+    int error;
+
+    if (backend == 0)
+    {
+        return -1;
+    }
+
+    error = backend->write(slaveAddr, writeAddress, data);
+    stats.transactions++;
+    stats.bytes += 5;
+    if (error != 0)
+    {
+        return error;
+    }
+
     uint16_t dataCheck;
     MLX90641_I2CRead(slaveAddr, writeAddress, 1, &dataCheck);
 
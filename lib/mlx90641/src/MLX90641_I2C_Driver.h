@@ -23,10 +23,41 @@ extern "C" {
 
 #include <stdint.h>
 
+// Read size asked from the transport when nothing else is configured
+#ifndef MLX90641_I2C_TRANSFER_BYTES
+#define MLX90641_I2C_TRANSFER_BYTES 128
+#endif
+
+// Transport used by MLX90641_I2CRead/Write/GeneralReset/FreqSet. Arduino builds
+// default to Wire; other builds must install a backend (e.g. the simulator).
+typedef struct
+{
+    int (*generalReset)(void);
+    int (*read)(uint8_t slaveAddr, uint16_t startAddress, uint16_t nMemAddressRead, uint16_t *data);
+    int (*write)(uint8_t slaveAddr, uint16_t writeAddress, uint16_t data);
+    void (*freqSet)(int kHz);
+    // Largest read, in bytes, the transport can do in one transaction when asked for the given size
+    uint16_t (*negotiateTransfer)(uint16_t bytes);
+} MLX90641_I2CBackend;
+
+typedef struct
+{
+    uint32_t transactions;
+    uint32_t bytes; // bytes on the bus including address and register bytes
+} MLX90641_I2CStats;
+
+void MLX90641_I2CSetBackend(const MLX90641_I2CBackend *backend);
+const MLX90641_I2CBackend *MLX90641_I2CGetBackend(void);
+
 int MLX90641_I2CGeneralReset(void);
 int MLX90641_I2CRead(uint8_t slaveAddr, uint16_t startAddress, uint16_t nMemAddressRead, uint16_t *data);
 int MLX90641_I2CWrite(uint8_t slaveAddr, uint16_t writeAddress, uint16_t data);
 void MLX90641_I2CFreqSet(int kHz);
+// Reads longer than the negotiated size are split into several transactions
+uint16_t MLX90641_I2CSetTransferSize(uint16_t bytes);
+uint16_t MLX90641_I2CGetTransferSize(void);
+void MLX90641_I2CGetStats(MLX90641_I2CStats *stats);
+void MLX90641_I2CResetStats(void);
 
 #ifdef __cplusplus
 } /* extern "C" */
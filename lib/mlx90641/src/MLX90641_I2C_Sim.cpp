@@ -0,0 +1,446 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "MLX90641_I2C_Sim.h"
+
+// The simulator keeps a full register image (about 2.5 KB of static RAM), so it
+// is only built for host targets unless a firmware opts in with MLX90641_I2C_SIM
+#if !defined(ARDUINO) || defined(MLX90641_I2C_SIM)
+
+#include <math.h>
+#include <string.h>
+
+#define SIM_EEPROM_START 0x2400
+#define SIM_EEPROM_WORDS 832
+#define SIM_RAM_START 0x0400
+#define SIM_RAM_WORDS 448
+#define SIM_STATUS_REG 0x8000
+#define SIM_CONTROL_REG 0x800D
+#define SIM_FRAME_WORDS 242
+
+// START, address byte, two register bytes, repeated START, address byte, STOP
+#define SIM_READ_HEADER_BITS (1 + 9 + 18 + 1 + 9 + 1)
+// START, address byte, two register bytes, two data bytes, STOP
+#define SIM_WRITE_BITS (1 + 9 + 36 + 1)
+
+static struct
+{
+    uint8_t slaveAddr;
+    uint16_t eeprom[SIM_EEPROM_WORDS];
+    uint16_t ram[SIM_RAM_WORDS];
+    uint16_t status;
+    uint16_t control;
+    const uint16_t *frames;
+    uint16_t frameCount;
+    uint16_t frameIndex;
+    MLX90641_SimTiming timing;
+    uint64_t timeNs;
+    uint64_t nextMeasurementNs;
+    MLX90641_SimStats stats;
+} sim;
+
+//------------------------------------------------------------------------------
+
+static uint64_t SimMeasurementPeriodNs(void)
+{
+    int refreshRate = (sim.control & 0x0380) >> 7;
+
+    // 0.5Hz for code 0, doubling with every step up to 64Hz
+    return 2000000000ULL >> refreshRate;
+}
+
+//------------------------------------------------------------------------------
+
+static void SimMeasure(void)
+{
+    const uint16_t *frame;
+    uint8_t subPage;
+
+    subPage = (sim.status & 0x0001) ^ 0x0001;
+
+    if (sim.frameCount > 0)
+    {
+        frame = sim.frames + (uint32_t)sim.frameIndex * SIM_FRAME_WORDS;
+        subPage = frame[241] & 0x0001;
+
+        for (int block = 0; block < 6; block++)
+        {
+            memcpy(&sim.ram[block * 64 + subPage * 32], &frame[block * 32], 32 * sizeof(uint16_t));
+        }
+        memcpy(&sim.ram[0x0180], &frame[192], 48 * sizeof(uint16_t));
+
+        sim.frameIndex = (sim.frameIndex + 1) % sim.frameCount;
+    }
+
+    sim.status = (sim.status & 0xFFF6) | 0x0008 | subPage;
+    sim.stats.measurements++;
+}
+
+//------------------------------------------------------------------------------
+
+static void SimSpend(uint32_t bits, uint32_t bytesReturned)
+{
+    uint64_t ns;
+
+    ns = (uint64_t)bits * 1000000 / sim.timing.kHz;
+    ns += (uint64_t)bytesReturned * sim.timing.stretchNs;
+    sim.stats.busNs += ns;
+    sim.timeNs += ns + sim.timing.overheadNs;
+    sim.stats.transactions++;
+    sim.stats.bytes += (bits + 8) / 9;
+
+    while (sim.timeNs >= sim.nextMeasurementNs)
+    {
+        SimMeasure();
+        sim.nextMeasurementNs += SimMeasurementPeriodNs();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static uint16_t SimReadWord(uint16_t address)
+{
+    if (address >= SIM_EEPROM_START && address < SIM_EEPROM_START + SIM_EEPROM_WORDS)
+    {
+        return sim.eeprom[address - SIM_EEPROM_START];
+    }
+    if (address >= SIM_RAM_START && address < SIM_RAM_START + SIM_RAM_WORDS)
+    {
+        return sim.ram[address - SIM_RAM_START];
+    }
+    if (address == SIM_STATUS_REG)
+    {
+        return sim.status;
+    }
+    if (address == SIM_CONTROL_REG)
+    {
+        return sim.control;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+static int SimGeneralReset(void)
+{
+    SimSpend(1 + 9 + 9 + 1, 0);
+
+    // Latches a triggered measurement (control bit 15), which then completes one period later
+    if ((sim.control & 0x8000) != 0)
+    {
+        sim.control &= 0x7FFF;
+        sim.nextMeasurementNs = sim.timeNs + SimMeasurementPeriodNs();
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+static int SimRead(uint8_t slaveAddr, uint16_t startAddress, uint16_t nMemAddressRead, uint16_t *data)
+{
+    if (slaveAddr != sim.slaveAddr)
+    {
+        SimSpend(1 + 9 + 1, 0);
+        return -1;
+    }
+
+    // Data is latched at the start of the transfer, time advances afterwards
+    for (int i = 0; i < nMemAddressRead; i++)
+    {
+        data[i] = SimReadWord(startAddress + i);
+    }
+    SimSpend(SIM_READ_HEADER_BITS + (uint32_t)nMemAddressRead * 18, (uint32_t)nMemAddressRead * 2);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+static int SimWrite(uint8_t slaveAddr, uint16_t writeAddress, uint16_t data)
+{
+    uint8_t restart = 0;
+
+    if (slaveAddr != sim.slaveAddr)
+    {
+        SimSpend(1 + 9 + 1, 0);
+        return -1;
+    }
+
+    if (writeAddress == SIM_STATUS_REG)
+    {
+        // Writing a zero to bit 3 clears the new data flag
+        sim.status = (sim.status & 0x0001) | (data & 0x0030) | (sim.status & data & 0x0008);
+    }
+    else if (writeAddress == SIM_CONTROL_REG)
+    {
+        restart = ((sim.control ^ data) & 0x0380) != 0;
+        sim.control = data;
+    }
+    SimSpend(SIM_WRITE_BITS, 0);
+
+    if (restart)
+    {
+        sim.nextMeasurementNs = sim.timeNs + SimMeasurementPeriodNs();
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+static void SimFreqSet(int kHz)
+{
+    sim.timing.kHz = kHz;
+}
+
+//------------------------------------------------------------------------------
+
+// The device auto-increments over the whole register map, so any size is fine
+static uint16_t SimNegotiateTransfer(uint16_t bytes)
+{
+    return bytes;
+}
+
+//------------------------------------------------------------------------------
+
+static const MLX90641_I2CBackend simBackend = {SimGeneralReset, SimRead, SimWrite, SimFreqSet, SimNegotiateTransfer};
+
+const MLX90641_I2CBackend *MLX90641_SimBackend(void)
+{
+    return &simBackend;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SimInit(uint8_t slaveAddr, const uint16_t *eeData)
+{
+    memset(&sim, 0, sizeof(sim));
+
+    sim.slaveAddr = slaveAddr;
+    memcpy(sim.eeprom, eeData, sizeof(sim.eeprom));
+    sim.control = sim.eeprom[12];
+    sim.status = 0x0001;
+    sim.timing.kHz = 400;
+    sim.nextMeasurementNs = SimMeasurementPeriodNs();
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SimSetFrames(const uint16_t *frames, uint16_t count)
+{
+    sim.frames = frames;
+    sim.frameCount = count;
+    sim.frameIndex = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SimSetTiming(const MLX90641_SimTiming *timing)
+{
+    sim.timing = *timing;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SimAdvance(uint32_t us)
+{
+    sim.timeNs += (uint64_t)us * 1000;
+
+    while (sim.timeNs >= sim.nextMeasurementNs)
+    {
+        SimMeasure();
+        sim.nextMeasurementNs += SimMeasurementPeriodNs();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+uint64_t MLX90641_SimGetTimeNs(void)
+{
+    return sim.timeNs;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SimGetStats(MLX90641_SimStats *stats)
+{
+    *stats = sim.stats;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SimResetStats(void)
+{
+    memset(&sim.stats, 0, sizeof(sim.stats));
+}
+
+//------------------------------------------------------------------------------
+
+static uint16_t SimHammingEncode(uint16_t data)
+{
+    uint16_t parity;
+    uint16_t word;
+
+    word = data & 0x07FF;
+
+    // Parity bits chosen so that every check in HammingDecode comes out zero
+    parity = __builtin_parity(word & 0x055B);
+    word |= parity << 11;
+    parity = __builtin_parity(word & 0x066D);
+    word |= parity << 12;
+    parity = __builtin_parity(word & 0x078E);
+    word |= parity << 13;
+    parity = __builtin_parity(word & 0x07F0);
+    word |= parity << 14;
+    parity = __builtin_parity(word & 0x7FFF);
+    word |= parity << 15;
+
+    return word;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SimSyntheticEEPROM(uint16_t *eeData)
+{
+    memset(eeData, 0, SIM_EEPROM_WORDS * sizeof(uint16_t));
+
+    eeData[10] = 0x0040;               // MLX90641 device select
+    eeData[12] = 0x0901;               // control register: 18 bit, 2Hz
+    eeData[16] = 2 << 5;               // offset scale 4
+    eeData[17] = 2016;                 // offset reference -1000
+    eeData[18] = 24;
+    eeData[21] = 80;                   // kta average, kta scales 14/0
+    eeData[22] = 14 << 5;
+    eeData[23] = 100;                  // kv average, kv scales 8/0
+    eeData[24] = 8 << 5;
+    eeData[25] = (12 << 5) | 12;       // alpha row scales 2^32
+    eeData[26] = (12 << 5) | 12;
+    eeData[27] = (12 << 5) | 12;
+    for (int i = 0; i < 6; i++)
+    {
+        eeData[28 + i] = 1500;         // row max alpha
+    }
+    eeData[34] = 2048 - 66;            // KsTa -0.002
+    eeData[35] = 512;                  // emissivity 1.0
+    eeData[36] = 187;                  // gain 6000
+    eeData[37] = 16;
+    eeData[38] = 2048 - 409;           // vdd25 -13088
+    eeData[39] = 2048 - 99;            // kVdd -3168
+    eeData[40] = 383;                  // vPTAT25 12273
+    eeData[41] = 17;
+    eeData[42] = 338;                  // KtPTAT 42.25
+    eeData[43] = 9;                    // KvPTAT 0.0022
+    eeData[44] = 1152;                 // alphaPTAT 9
+    eeData[45] = 1200;                 // CP alpha 1200 / 2^38
+    eeData[46] = 38;
+    eeData[47] = 2046;                 // CP offset -60
+    eeData[48] = 4;
+    eeData[49] = (12 << 6) | 16;       // CP kta
+    eeData[50] = (5 << 6) | 8;         // CP kv
+    eeData[51] = (2 << 9) | 32;        // resolution 2, tgc 0.5
+    eeData[52] = 17;                   // KsTo scale
+    for (int i = 53; i < 64; i++)
+    {
+        eeData[i] = 2048 - 105;        // KsTo -0.0008
+    }
+    eeData[58] = 200;                  // corner temperatures
+    eeData[60] = 280;
+    eeData[62] = 300;
+
+    for (int i = 0; i < 192; i++)
+    {
+        eeData[64 + i] = ((i * 7) % 41 - 20) & 0x07FF;
+        eeData[256 + i] = 1600 + (i * 13) % 300;
+        eeData[448 + i] = (((i % 9 - 4) & 0x3F) << 5) | ((i % 5 - 2) & 0x1F);
+        eeData[640 + i] = ((i * 11) % 37 - 18) & 0x07FF;
+    }
+
+    for (int i = 16; i < SIM_EEPROM_WORDS; i++)
+    {
+        eeData[i] = SimHammingEncode(eeData[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_SimSyntheticFrame(const paramsMLX90641 *params, const float *sceneTemps, float ta, uint8_t subPage,
+                                uint16_t *frameData)
+{
+    double ptat;
+    double vPTAT;
+    double vdd;
+    double taK;
+    double irDataCP;
+    double alphaCorrR[8];
+    double alphaCompensated;
+    double irData;
+    double To;
+    int range;
+
+    memset(frameData, 0, SIM_FRAME_WORDS * sizeof(uint16_t));
+
+    // Nominal supply, matching resolution, unity gain: only Ta and the scene vary
+    frameData[240] = (params->resolutionEE << 10) | 0x0181;
+    frameData[241] = subPage;
+    frameData[234] = params->vdd25;
+    frameData[202] = params->gainEE;
+    frameData[200] = params->cpOffset;
+
+    ptat = 1500;
+    vPTAT = params->vPTAT25 + params->KtPTAT * (ta - 25);
+    frameData[224] = ptat;
+    frameData[192] = lround(ptat * 262144 / vPTAT - ptat * params->alphaPTAT);
+
+    vdd = MLX90641_GetVdd(frameData, params);
+    ta = MLX90641_GetTa(frameData, params);
+    taK = pow(ta + 273.15, 4);
+    irDataCP = params->cpOffset - params->cpOffset * (1 + params->cpKta * (ta - 25)) * (1 + params->cpKv * (vdd - 3.3));
+
+    alphaCorrR[1] = 1 / (1 + params->ksTo[1] * 20);
+    alphaCorrR[0] = alphaCorrR[1] / (1 + params->ksTo[0] * 20);
+    alphaCorrR[2] = 1;
+    alphaCorrR[3] = (1 + params->ksTo[2] * params->ct[3]);
+    for (int i = 4; i < 8; i++)
+    {
+        alphaCorrR[i] = alphaCorrR[i - 1] * (1 + params->ksTo[i - 1] * (params->ct[i] - params->ct[i - 1]));
+    }
+
+    // Inverse of the per-range To equation with emissivity 1 and tr = Ta
+    for (int i = 0; i < 192; i++)
+    {
+        To = sceneTemps[i];
+        range = 0;
+        while (range < 7 && To >= params->ct[range + 1])
+        {
+            range++;
+        }
+
+        alphaCompensated = SCALEALPHA * pow(2, (double)params->alphaScale) / params->alpha[i];
+        alphaCompensated = alphaCompensated * (1 + params->KsTa * (ta - 25));
+        irData = alphaCompensated * alphaCorrR[range] * (1 + params->ksTo[range] * (To - params->ct[range])) *
+                 (pow(To + 273.15, 4) - taK);
+
+        irData = irData + params->tgc * irDataCP;
+        irData = irData + params->offset[subPage][i] *
+                              (1 + params->kta[i] / pow(2, (double)params->ktaScale) * (ta - 25)) *
+                              (1 + params->kv[i] / pow(2, (double)params->kvScale) * (vdd - 3.3));
+
+        frameData[i] = (int16_t)lround(irData);
+    }
+}
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef _MLX90641_I2C_SIM_H_
+#define _MLX90641_I2C_SIM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "MLX90641_API.h"
+#include "MLX90641_I2C_Driver.h"
+
+// Simulated MLX90641 behind the I2C backend interface. Register map:
+// EEPROM 0x2400-0x273F, RAM 0x0400-0x05BF, status 0x8000, control 0x800D.
+// Time is virtual: every transaction advances the clock by its bus time and
+// a new sub-page is measured whenever the clock passes the refresh period.
+// Arduino builds only compile it with -D MLX90641_I2C_SIM.
+
+typedef struct
+{
+    uint16_t kHz;          // SCL frequency
+    uint16_t stretchNs;    // clock stretch the device inserts before each byte it returns
+    uint16_t overheadNs;   // host side cost per transaction (driver call, START/STOP setup)
+} MLX90641_SimTiming;
+
+typedef struct
+{
+    uint32_t transactions;
+    uint32_t bytes;        // bytes on the bus including address and register bytes
+    uint32_t measurements; // sub-pages measured by the device
+    uint64_t busNs;        // total time the bus was busy
+} MLX90641_SimStats;
+
+void MLX90641_SimInit(uint8_t slaveAddr, const uint16_t *eeData);
+void MLX90641_SimSetFrames(const uint16_t *frames, uint16_t count);
+void MLX90641_SimSetTiming(const MLX90641_SimTiming *timing);
+void MLX90641_SimAdvance(uint32_t us);
+uint64_t MLX90641_SimGetTimeNs(void);
+void MLX90641_SimGetStats(MLX90641_SimStats *stats);
+void MLX90641_SimResetStats(void);
+const MLX90641_I2CBackend *MLX90641_SimBackend(void);
+
+void MLX90641_SimSyntheticEEPROM(uint16_t *eeData);
+void MLX90641_SimSyntheticFrame(const paramsMLX90641 *params, const float *sceneTemps, float ta, uint8_t subPage,
+                                uint16_t *frameData);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
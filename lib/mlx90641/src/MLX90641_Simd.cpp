@@ -0,0 +1,157 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "MLX90641_API.h"
+#include "MLX90641_Simd.h"
+#include "MLX90641_Stats.h"
+
+//------------------------------------------------------------------------------
+
+const char *MLX90641_SimdName(void)
+{
+    return MLX90641_SIMD_NAME;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90641_CalculateToSimd(uint16_t *frameData, const paramsMLX90641 *params, const calibMLX90641 *calib,
+                              float emissivity, float tr, float *result, const MLX90641_Layout *layout,
+                              MLX90641_FrameStats *stats)
+{
+    float vdd;
+    float ta;
+    float ta4;
+    float tr4;
+    float taTr;
+    float gain;
+    float irDataCP;
+    float alphaCorrR[8];
+    float irRaw[192];
+    uint16_t subPage;
+
+    if (stats != NULL)
+    {
+        MLX90641_FrameStatsReset(stats);
+    }
+    subPage = frameData[241];
+    vdd = MLX90641_GetVdd(frameData, params);
+    ta = MLX90641_GetTa(frameData, params);
+    ta4 = (ta + 273.15f);
+    ta4 = ta4 * ta4;
+    ta4 = ta4 * ta4;
+    tr4 = (tr + 273.15f);
+    tr4 = tr4 * tr4;
+    tr4 = tr4 * tr4;
+
+    taTr = tr4 - (tr4 - ta4) / emissivity;
+
+    alphaCorrR[1] = 1 / (1 + params->ksTo[1] * 20);
+    alphaCorrR[0] = alphaCorrR[1] / (1 + params->ksTo[0] * 20);
+    alphaCorrR[2] = 1;
+    alphaCorrR[3] = (1 + params->ksTo[2] * params->ct[3]);
+    alphaCorrR[4] = alphaCorrR[3] * (1 + params->ksTo[3] * (params->ct[4] - params->ct[3]));
+    alphaCorrR[5] = alphaCorrR[4] * (1 + params->ksTo[4] * (params->ct[5] - params->ct[4]));
+    alphaCorrR[6] = alphaCorrR[5] * (1 + params->ksTo[5] * (params->ct[6] - params->ct[5]));
+    alphaCorrR[7] = alphaCorrR[6] * (1 + params->ksTo[6] * (params->ct[7] - params->ct[6]));
+
+    //------------------------- Gain calculation -----------------------------------
+    gain = (int16_t)frameData[202];
+    gain = params->gainEE / gain;
+
+    //------------------------- To calculation -------------------------------------
+    irDataCP = (int16_t)frameData[200];
+    irDataCP = irDataCP * gain;
+    irDataCP = irDataCP - params->cpOffset * (1 + params->cpKta * (ta - 25)) * (1 + params->cpKv * (vdd - 3.3f));
+
+    for (int pixelNumber = 0; pixelNumber < 192; pixelNumber++)
+    {
+        irRaw[pixelNumber] = (int16_t)frameData[pixelNumber];
+    }
+
+    const float *offset = calib->offset[subPage];
+    const vfloat vGain = VSet(gain);
+    const vfloat vOne = VSet(1);
+    const vfloat vTaDelta = VSet(ta - 25);
+    const vfloat vVddDelta = VSet(vdd - 3.3f);
+    const vfloat vTgcCP = VSet(params->tgc * irDataCP);
+    const vfloat vEmissivity = VSet(emissivity);
+    const vfloat vKsTa = VSet(1 + params->KsTa * (ta - 25));
+    const vfloat vTaTr = VSet(taTr);
+    const vfloat vKsTo2 = VSet(params->ksTo[2]);
+    const vfloat vKsTo2Abs = VSet(1 - params->ksTo[2] * 273.15f);
+    const vfloat vKelvin = VSet(273.15f);
+
+    for (int pixelNumber = 0; pixelNumber < 192; pixelNumber += MLX90641_SIMD_WIDTH)
+    {
+        vfloat irData;
+        vfloat alphaCompensated;
+        vfloat Sx;
+        vfloat To;
+        vfloat corr;
+        vfloat ksTo;
+        vfloat ct;
+
+        irData = VMul(VLoad(irRaw + pixelNumber), vGain);
+        irData = VSub(irData, VMul(VMul(VLoad(offset + pixelNumber),
+                                        VAdd(vOne, VMul(VLoad(calib->kta + pixelNumber), vTaDelta))),
+                                   VAdd(vOne, VMul(VLoad(calib->kv + pixelNumber), vVddDelta))));
+        irData = VSub(irData, vTgcCP);
+        irData = VDiv(irData, vEmissivity);
+
+        alphaCompensated = VMul(VLoad(calib->alpha + pixelNumber), vKsTa);
+
+        Sx = VMul(VMul(alphaCompensated, VMul(alphaCompensated, alphaCompensated)),
+                  VAdd(irData, VMul(alphaCompensated, vTaTr)));
+        Sx = VMul(VSqrt(VSqrt(Sx)), vKsTo2);
+
+        To = VDiv(irData, VAdd(VMul(alphaCompensated, vKsTo2Abs), Sx));
+        To = VSub(VSqrt(VSqrt(VAdd(To, vTaTr))), vKelvin);
+
+        // Branchless range lookup: select the coefficients of the highest corner
+        // temperature To is not below, which is what the if/else chain picks,
+        // including range 7 for a NaN To.
+        corr = VSet(alphaCorrR[0]);
+        ksTo = VSet(params->ksTo[0]);
+        ct = VSet(params->ct[0]);
+        for (int range = 1; range < 8; range++)
+        {
+            vmask above = VNotLess(To, VSet(params->ct[range]));
+            corr = VSelect(above, VSet(alphaCorrR[range]), corr);
+            ksTo = VSelect(above, VSet(params->ksTo[range]), ksTo);
+            ct = VSelect(above, VSet(params->ct[range]), ct);
+        }
+
+        To = VMul(VMul(alphaCompensated, corr), VAdd(vOne, VMul(ksTo, VSub(To, ct))));
+        To = VSub(VSqrt(VSqrt(VAdd(VDiv(irData, To), vTaTr))), vKelvin);
+
+        // the lanes are consecutive sensor pixels, other layouts take them one by one
+        if (layout == NULL && stats == NULL)
+        {
+            VStore(result + pixelNumber, To);
+            continue;
+        }
+        float lanes[MLX90641_SIMD_WIDTH];
+        VStore(lanes, To);
+        for (int lane = 0; lane < MLX90641_SIMD_WIDTH; lane++)
+        {
+            result[MLX90641_LayoutOffset(layout, pixelNumber + lane)] = lanes[lane];
+            if (stats != NULL)
+            {
+                FrameStatsAddFloat(stats, pixelNumber + lane, lanes[lane]);
+            }
+        }
+    }
+}
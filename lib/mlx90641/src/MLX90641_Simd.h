@@ -0,0 +1,108 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef _MLX90641_SIMD_H_
+#define _MLX90641_SIMD_H_
+
+// Minimal float vector abstraction for the To kernel. The widest instruction set
+// enabled at compile time is used: AVX-512 (16 lanes), AVX (8), SSE (4), NEON (4),
+// otherwise plain floats (1 lane), which is what the ESP targets get.
+// VNotLess is !(a < b), true for NaN like the else branches of the scalar code.
+
+#include <math.h>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define MLX90641_SIMD_NAME "avx512"
+#define MLX90641_SIMD_WIDTH 16
+typedef __m512 vfloat;
+typedef __mmask16 vmask;
+static inline vfloat VLoad(const float *p) { return _mm512_loadu_ps(p); }
+static inline void VStore(float *p, vfloat a) { _mm512_storeu_ps(p, a); }
+static inline vfloat VSet(float a) { return _mm512_set1_ps(a); }
+static inline vfloat VAdd(vfloat a, vfloat b) { return _mm512_add_ps(a, b); }
+static inline vfloat VSub(vfloat a, vfloat b) { return _mm512_sub_ps(a, b); }
+static inline vfloat VMul(vfloat a, vfloat b) { return _mm512_mul_ps(a, b); }
+static inline vfloat VDiv(vfloat a, vfloat b) { return _mm512_div_ps(a, b); }
+static inline vfloat VSqrt(vfloat a) { return _mm512_sqrt_ps(a); }
+static inline vmask VNotLess(vfloat a, vfloat b) { return _mm512_cmp_ps_mask(a, b, _CMP_NLT_UQ); }
+static inline vfloat VSelect(vmask m, vfloat a, vfloat b) { return _mm512_mask_blend_ps(m, b, a); }
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define MLX90641_SIMD_NAME "avx"
+#define MLX90641_SIMD_WIDTH 8
+typedef __m256 vfloat;
+typedef __m256 vmask;
+static inline vfloat VLoad(const float *p) { return _mm256_loadu_ps(p); }
+static inline void VStore(float *p, vfloat a) { _mm256_storeu_ps(p, a); }
+static inline vfloat VSet(float a) { return _mm256_set1_ps(a); }
+static inline vfloat VAdd(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+static inline vfloat VSub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+static inline vfloat VMul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+static inline vfloat VDiv(vfloat a, vfloat b) { return _mm256_div_ps(a, b); }
+static inline vfloat VSqrt(vfloat a) { return _mm256_sqrt_ps(a); }
+static inline vmask VNotLess(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_NLT_UQ); }
+static inline vfloat VSelect(vmask m, vfloat a, vfloat b) { return _mm256_blendv_ps(b, a, m); }
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MLX90641_SIMD_NAME "sse"
+#define MLX90641_SIMD_WIDTH 4
+typedef __m128 vfloat;
+typedef __m128 vmask;
+static inline vfloat VLoad(const float *p) { return _mm_loadu_ps(p); }
+static inline void VStore(float *p, vfloat a) { _mm_storeu_ps(p, a); }
+static inline vfloat VSet(float a) { return _mm_set1_ps(a); }
+static inline vfloat VAdd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+static inline vfloat VSub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+static inline vfloat VMul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+static inline vfloat VDiv(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+static inline vfloat VSqrt(vfloat a) { return _mm_sqrt_ps(a); }
+static inline vmask VNotLess(vfloat a, vfloat b) { return _mm_cmpnlt_ps(a, b); }
+static inline vfloat VSelect(vmask m, vfloat a, vfloat b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MLX90641_SIMD_NAME "neon"
+#define MLX90641_SIMD_WIDTH 4
+typedef float32x4_t vfloat;
+typedef uint32x4_t vmask;
+static inline vfloat VLoad(const float *p) { return vld1q_f32(p); }
+static inline void VStore(float *p, vfloat a) { vst1q_f32(p, a); }
+static inline vfloat VSet(float a) { return vdupq_n_f32(a); }
+static inline vfloat VAdd(vfloat a, vfloat b) { return vaddq_f32(a, b); }
+static inline vfloat VSub(vfloat a, vfloat b) { return vsubq_f32(a, b); }
+static inline vfloat VMul(vfloat a, vfloat b) { return vmulq_f32(a, b); }
+static inline vfloat VDiv(vfloat a, vfloat b) { return vdivq_f32(a, b); }
+static inline vfloat VSqrt(vfloat a) { return vsqrtq_f32(a); }
+static inline vmask VNotLess(vfloat a, vfloat b) { return vmvnq_u32(vcltq_f32(a, b)); }
+static inline vfloat VSelect(vmask m, vfloat a, vfloat b) { return vbslq_f32(m, a, b); }
+#else
+#define MLX90641_SIMD_NAME "scalar"
+#define MLX90641_SIMD_WIDTH 1
+typedef float vfloat;
+typedef bool vmask;
+static inline vfloat VLoad(const float *p) { return *p; }
+static inline void VStore(float *p, vfloat a) { *p = a; }
+static inline vfloat VSet(float a) { return a; }
+static inline vfloat VAdd(vfloat a, vfloat b) { return a + b; }
+static inline vfloat VSub(vfloat a, vfloat b) { return a - b; }
+static inline vfloat VMul(vfloat a, vfloat b) { return a * b; }
+static inline vfloat VDiv(vfloat a, vfloat b) { return a / b; }
+static inline vfloat VSqrt(vfloat a) { return sqrtf(a); }
+static inline vmask VNotLess(vfloat a, vfloat b) { return !(a < b); }
+static inline vfloat VSelect(vmask m, vfloat a, vfloat b) { return m ? a : b; }
+#endif
+
+#endif
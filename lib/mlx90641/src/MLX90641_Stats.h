@@ -0,0 +1,82 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef _MLX90641_STATS_H_
+#define _MLX90641_STATS_H_
+
+// Per pixel step of MLX90641_FrameStats, inlined into the To kernels
+
+#include "MLX90641_API.h"
+
+static inline void FrameStatsAdd(MLX90641_FrameStats *stats, uint8_t pixelNumber, int32_t centi)
+{
+    int32_t bin;
+
+    if (centi > INT16_MAX)
+    {
+        centi = INT16_MAX;
+    }
+    else if (centi < INT16_MIN)
+    {
+        centi = INT16_MIN;
+    }
+
+    if (stats->count == 0 || centi < stats->min)
+    {
+        stats->min = centi;
+        stats->argMin = pixelNumber;
+    }
+    if (stats->count == 0 || centi > stats->max)
+    {
+        stats->max = centi;
+        stats->argMax = pixelNumber;
+    }
+    stats->count++;
+    stats->sum += centi;
+    stats->sumSquares += centi * centi;
+
+    bin = (centi - stats->histogramLow) / (int32_t)stats->histogramWidth;
+    if (centi < stats->histogramLow)
+    {
+        bin = 0;
+    }
+    else if (bin >= MLX90641_HISTOGRAM_BINS)
+    {
+        bin = MLX90641_HISTOGRAM_BINS - 1;
+    }
+    stats->histogram[bin]++;
+}
+
+static inline void FrameStatsAddFloat(MLX90641_FrameStats *stats, uint8_t pixelNumber, float to)
+{
+    if (to != to)
+    {
+        return;
+    }
+    // clamp before the conversion, out of range float to int is undefined
+    to = to * 100;
+    if (to > INT16_MAX)
+    {
+        to = INT16_MAX;
+    }
+    else if (to < INT16_MIN)
+    {
+        to = INT16_MIN;
+    }
+    FrameStatsAdd(stats, pixelNumber, (int32_t)(to < 0 ? to - 0.5f : to + 0.5f));
+}
+
+#endif
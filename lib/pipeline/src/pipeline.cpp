@@ -0,0 +1,204 @@
+#if defined(ESP32) || !defined(ARDUINO)
+
+#include "pipeline.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Queue waits are bounded so the tasks notice pipelineStop
+#define PIPELINE_POLL_TICKS pdMS_TO_TICKS(100)
+
+static void record(PipelineStage &stage, uint64_t start)
+{
+    uint32_t us = rtosMicros() - start;
+
+    stage.count++;
+    stage.lastUs = us;
+    stage.totalUs += us;
+    if (us > stage.maxUs)
+    {
+        stage.maxUs = us;
+    }
+}
+
+static uint8_t *buffer(Pipeline &pipeline, uint8_t index)
+{
+    return pipeline.pool + (size_t)index * pipeline.config.frameBytes;
+}
+
+static void finishTask(Pipeline &pipeline)
+{
+    pipeline.activeTasks--;
+    vTaskDelete(NULL);
+}
+
+//------------------------------------------------------------------------------
+
+static void acquireTask(void *parameter)
+{
+    Pipeline &pipeline = *(Pipeline *)parameter;
+    uint8_t index;
+
+    while (pipeline.running)
+    {
+        if (xQueueReceive(pipeline.freeQueue, &index, 0) != pdTRUE)
+        {
+            // processing is behind, the oldest waiting frame is the least useful one
+            if (xQueueReceive(pipeline.readyQueue, &index, PIPELINE_POLL_TICKS) != pdTRUE)
+            {
+                continue;
+            }
+            pipeline.stats.dropped++;
+        }
+
+        uint64_t start = rtosMicros();
+        if (!pipeline.config.acquire(buffer(pipeline, index), pipeline.config.context))
+        {
+            pipeline.stats.errors++;
+            xQueueSend(pipeline.freeQueue, &index, portMAX_DELAY);
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        record(pipeline.stats.acquire, start);
+
+        pipeline.acquiredUs[index] = rtosMicros();
+        xQueueSend(pipeline.readyQueue, &index, portMAX_DELAY);
+        UBaseType_t waiting = uxQueueMessagesWaiting(pipeline.readyQueue);
+        if (waiting > pipeline.stats.readyHighWater)
+        {
+            pipeline.stats.readyHighWater = waiting;
+        }
+    }
+
+    finishTask(pipeline);
+}
+
+//------------------------------------------------------------------------------
+
+static void processTask(void *parameter)
+{
+    Pipeline &pipeline = *(Pipeline *)parameter;
+    uint8_t index;
+
+    while (pipeline.running)
+    {
+        if (xQueueReceive(pipeline.readyQueue, &index, PIPELINE_POLL_TICKS) != pdTRUE)
+        {
+            continue;
+        }
+
+        uint64_t start = rtosMicros();
+        record(pipeline.stats.wait, pipeline.acquiredUs[index]);
+        pipeline.config.process(buffer(pipeline, index), pipeline.config.context);
+        record(pipeline.stats.process, start);
+
+        xQueueSend(pipeline.freeQueue, &index, portMAX_DELAY);
+    }
+
+    finishTask(pipeline);
+}
+
+//------------------------------------------------------------------------------
+
+static void serveTask(void *parameter)
+{
+    Pipeline &pipeline = *(Pipeline *)parameter;
+
+    while (pipeline.running)
+    {
+        uint64_t start = rtosMicros();
+        pipeline.config.serve(pipeline.config.context);
+        record(pipeline.stats.serve, start);
+
+        // lets the idle task on this core run and feed its watchdog
+        vTaskDelay(1);
+    }
+
+    finishTask(pipeline);
+}
+
+//------------------------------------------------------------------------------
+
+void pipelineDefaults(PipelineConfig &config)
+{
+    memset(&config, 0, sizeof(config));
+    config.buffers = 3;
+    config.acquireCore = 1;
+    config.processCore = 1;
+    config.serveCore = 0;
+    // the sensor read mostly waits on I2C, it must not wait behind processing
+    config.acquirePriority = 3;
+    config.processPriority = 2;
+    config.servePriority = 2;
+    config.acquireStackBytes = 4096;
+    config.processStackBytes = 4096;
+    // request handlers build whole payloads, e.g. /raw of a 768 pixel frame
+    config.serveStackBytes = 10240;
+}
+
+//------------------------------------------------------------------------------
+
+bool pipelineStart(Pipeline &pipeline, const PipelineConfig &config)
+{
+    if (config.buffers < 2 || config.buffers > PIPELINE_MAX_BUFFERS)
+    {
+        return false;
+    }
+
+    pipeline.config = config;
+    memset(&pipeline.stats, 0, sizeof(pipeline.stats));
+    pipeline.pool = (uint8_t *)malloc((size_t)config.buffers * config.frameBytes);
+    pipeline.freeQueue = xQueueCreate(config.buffers, sizeof(uint8_t));
+    pipeline.readyQueue = xQueueCreate(config.buffers, sizeof(uint8_t));
+    if (pipeline.pool == NULL || pipeline.freeQueue == NULL || pipeline.readyQueue == NULL)
+    {
+        if (pipeline.freeQueue != NULL)
+        {
+            vQueueDelete(pipeline.freeQueue);
+        }
+        if (pipeline.readyQueue != NULL)
+        {
+            vQueueDelete(pipeline.readyQueue);
+        }
+        free(pipeline.pool);
+        return false;
+    }
+    for (uint8_t i = 0; i < config.buffers; i++)
+    {
+        xQueueSend(pipeline.freeQueue, &i, 0);
+    }
+
+    pipeline.running = true;
+    pipeline.activeTasks = 3;
+    xTaskCreatePinnedToCore(acquireTask, "acquire", config.acquireStackBytes, &pipeline, config.acquirePriority, NULL,
+                            config.acquireCore);
+    xTaskCreatePinnedToCore(processTask, "process", config.processStackBytes, &pipeline, config.processPriority, NULL,
+                            config.processCore);
+    xTaskCreatePinnedToCore(serveTask, "serve", config.serveStackBytes, &pipeline, config.servePriority, NULL,
+                            config.serveCore);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void pipelineStop(Pipeline &pipeline)
+{
+    pipeline.running = false;
+    while (pipeline.activeTasks > 0)
+    {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    vQueueDelete(pipeline.freeQueue);
+    vQueueDelete(pipeline.readyQueue);
+    free(pipeline.pool);
+    pipeline.pool = NULL;
+}
+
+//------------------------------------------------------------------------------
+
+void pipelineResetStats(Pipeline &pipeline)
+{
+    memset(&pipeline.stats, 0, sizeof(pipeline.stats));
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos.h"
+
+// Camera pipeline of three pinned tasks:
+//
+//   acquire --ready queue--> process        serve
+//      ^                        |
+//      +-------free queue-------+
+//
+// Frames travel as indices into a pool of buffers, so the queues are bounded
+// by the pool size and nothing is copied. When processing falls behind the
+// acquisition reuses the oldest waiting frame (counted as dropped) instead of
+// stalling the sensor. Serving runs on its own, next to the WiFi stack, so a
+// request never waits for a frame read; process publishes whatever serve needs.
+
+#define PIPELINE_MAX_BUFFERS 8
+
+struct PipelineStage
+{
+    uint32_t count;
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+};
+
+// Written by the tasks while running; fields may be a round apart when read
+struct PipelineStats
+{
+    PipelineStage acquire;
+    PipelineStage process;
+    PipelineStage serve;
+    PipelineStage wait; // frame age between acquisition and the start of processing
+    uint32_t errors;    // failed acquisitions
+    uint32_t dropped;   // frames overwritten before they were processed
+    uint32_t readyHighWater;
+};
+
+struct PipelineConfig
+{
+    size_t frameBytes;
+    uint8_t buffers; // 2..PIPELINE_MAX_BUFFERS
+    // reads one frame into frame, blocking for as long as the sensor needs
+    bool (*acquire)(void *frame, void *context);
+    void (*process)(const void *frame, void *context);
+    // one round of network handling
+    void (*serve)(void *context);
+    void *context;
+    BaseType_t acquireCore;
+    BaseType_t processCore;
+    BaseType_t serveCore;
+    UBaseType_t acquirePriority;
+    UBaseType_t processPriority;
+    UBaseType_t servePriority;
+    uint32_t acquireStackBytes;
+    uint32_t processStackBytes;
+    uint32_t serveStackBytes; // the web server handlers run on this stack
+};
+
+struct Pipeline
+{
+    PipelineConfig config;
+    uint8_t *pool;
+    uint64_t acquiredUs[PIPELINE_MAX_BUFFERS];
+    QueueHandle_t freeQueue;
+    QueueHandle_t readyQueue;
+    std::atomic<bool> running;
+    std::atomic<int> activeTasks;
+    PipelineStats stats;
+};
+
+// Fills config with the ESP32 layout: acquisition and processing on the
+// application core, serving on the protocol core where WiFi runs.
+void pipelineDefaults(PipelineConfig &config);
+bool pipelineStart(Pipeline &pipeline, const PipelineConfig &config);
+// Waits for the tasks to finish their current round
+void pipelineStop(Pipeline &pipeline);
+void pipelineResetStats(Pipeline &pipeline);
+
+#endif
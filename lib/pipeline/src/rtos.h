@@ -0,0 +1,56 @@
+#ifndef RTOS_H
+#define RTOS_H
+
+// The subset of FreeRTOS the pipeline uses. ESP32 builds get the real thing,
+// Linux builds a thread based stand-in (rtos_shim.cpp) so the same code runs
+// in host tests: one tick is one millisecond as on the ESP32 Arduino core and
+// the core arguments are ignored.
+
+#include <stdint.h>
+
+#if defined(ESP32)
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+static inline uint64_t rtosMicros(void)
+{
+    return esp_timer_get_time();
+}
+#elif !defined(ARDUINO)
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void (*TaskFunction_t)(void *);
+typedef struct RtosTask *TaskHandle_t;
+typedef struct RtosQueue *QueueHandle_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait);
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait);
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameter,
+                                   UBaseType_t priority, TaskHandle_t *task, BaseType_t core);
+// the shim only supports a task deleting itself as its last statement
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+
+uint64_t rtosMicros(void);
+#else
+#error "rtos.h needs FreeRTOS (ESP32) or a host build"
+#endif
+
+#endif
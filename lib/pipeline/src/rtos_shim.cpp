@@ -0,0 +1,140 @@
+#if !defined(ESP32) && !defined(ARDUINO)
+
+#include "rtos.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+struct RtosQueue
+{
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::vector<uint8_t>> items;
+    size_t length;
+    size_t itemSize;
+};
+
+static bool waitFor(RtosQueue *queue, std::unique_lock<std::mutex> &lock, TickType_t wait, bool forItem)
+{
+    auto ready = [queue, forItem] { return forItem ? !queue->items.empty() : queue->items.size() < queue->length; };
+
+    if (wait == portMAX_DELAY)
+    {
+        queue->changed.wait(lock, ready);
+        return true;
+    }
+    return queue->changed.wait_for(lock, std::chrono::milliseconds(wait), ready);
+}
+
+//------------------------------------------------------------------------------
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    RtosQueue *queue = new RtosQueue;
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    const uint8_t *bytes = (const uint8_t *)item;
+
+    if (!waitFor(queue, lock, wait, false))
+    {
+        return pdFALSE;
+    }
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    const uint8_t *bytes = (const uint8_t *)item;
+
+    queue->items.clear();
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+
+    if (!waitFor(queue, lock, wait, true))
+    {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+
+    if (!waitFor(queue, lock, wait, true))
+    {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    return queue->items.size();
+}
+
+//------------------------------------------------------------------------------
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameter,
+                                   UBaseType_t priority, TaskHandle_t *task, BaseType_t core)
+{
+    // names, stacks, priorities and cores have no meaning for host threads
+    (void)name;
+    (void)stackDepth;
+    (void)priority;
+    (void)core;
+    std::thread(function, parameter).detach();
+    if (task != NULL)
+    {
+        *task = NULL;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+uint64_t rtosMicros(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+#endif
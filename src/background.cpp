@@ -0,0 +1,65 @@
+#include "background.h"
+
+BackgroundConfig backgroundDefaults()
+{
+    BackgroundConfig config;
+
+    config.alpha = 0.02f;
+    config.zThreshold = 3.0f;
+    config.minVariance = 0.04f; // 0.2 K, about the pixel noise at 4 Hz
+    return config;
+}
+
+void backgroundUpdate(BackgroundState &state, float *mean, float *variance, const float *frame, int rows, int cols,
+                      FrameMask &foreground)
+{
+    const BackgroundConfig &config = state.config;
+    const float z2 = config.zThreshold * config.zThreshold;
+    float rate = 1.0f / (state.frames + 1);
+
+    if (rate < config.alpha)
+    {
+        rate = config.alpha;
+    }
+
+    foreground.rows = rows;
+    foreground.cols = cols;
+    for (int r = 0; r < rows; r++)
+    {
+        uint32_t bits = 0;
+        for (int c = 0; c < cols; c++)
+        {
+            float value = frame[c];
+            float delta = value - mean[c];
+
+            if (value != value)
+            {
+                continue; // a NaN would stick in the mean
+            }
+            if (variance[c] == 0)
+            {
+                mean[c] = value;
+                variance[c] = BACKGROUND_INITIAL_VARIANCE;
+            }
+            else if (delta > 0 && delta * delta > z2 * variance[c])
+            {
+                bits |= (uint32_t)1 << c;
+            }
+            else
+            {
+                mean[c] += rate * delta;
+                float learned = (1.0f - rate) * (variance[c] + rate * delta * delta);
+                variance[c] = learned > config.minVariance ? learned : config.minVariance;
+            }
+        }
+        foreground.bits[r] = bits;
+        frame += cols;
+        mean += cols;
+        variance += cols;
+    }
+
+    if (state.frames < UINT32_MAX)
+    {
+        state.frames++;
+    }
+}
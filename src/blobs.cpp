@@ -0,0 +1,191 @@
+#include "blobs.h"
+#include <string.h>
+
+static uint16_t findRoot(BlobRegion *regions, uint16_t label)
+{
+    while (regions[label].parent != label)
+    {
+        // path halving
+        regions[label].parent = regions[regions[label].parent].parent;
+        label = regions[label].parent;
+    }
+    return label;
+}
+
+// Joins the sets of a and b; the older (lower) label stays the root and takes the statistics
+static uint16_t join(BlobRegion *regions, uint16_t a, uint16_t b)
+{
+    a = findRoot(regions, a);
+    b = findRoot(regions, b);
+    if (a == b)
+    {
+        return a;
+    }
+    if (b < a)
+    {
+        uint16_t swap = a;
+        a = b;
+        b = swap;
+    }
+
+    BlobRegion &root = regions[a];
+    const BlobRegion &child = regions[b];
+    root.area += child.area;
+    root.sumRow += child.sumRow;
+    root.sumCol += child.sumCol;
+    root.top = root.top < child.top ? root.top : child.top;
+    root.left = root.left < child.left ? root.left : child.left;
+    root.bottom = root.bottom > child.bottom ? root.bottom : child.bottom;
+    root.right = root.right > child.right ? root.right : child.right;
+    if (child.peak > root.peak)
+    {
+        root.peak = child.peak;
+        root.peakIndex = child.peakIndex;
+    }
+    regions[b].parent = a;
+
+    return a;
+}
+
+static void addPixel(BlobRegion &region, int r, int c, float value, uint16_t index)
+{
+    region.area++;
+    region.sumRow += r;
+    region.sumCol += c;
+    if (r > region.bottom)
+    {
+        region.bottom = r;
+    }
+    if (c < region.left)
+    {
+        region.left = c;
+    }
+    if (c > region.right)
+    {
+        region.right = c;
+    }
+    if (value > region.peak)
+    {
+        region.peak = value;
+        region.peakIndex = index;
+    }
+}
+
+static void insertBlob(BlobList &list, const Blob &blob)
+{
+    int position = list.count;
+
+    if (list.count == BLOB_MAX_BLOBS)
+    {
+        list.overflow = true;
+        if (blob.area <= list.blobs[BLOB_MAX_BLOBS - 1].area)
+        {
+            return;
+        }
+        position = BLOB_MAX_BLOBS - 1;
+    }
+    else
+    {
+        list.count++;
+    }
+
+    while (position > 0 && list.blobs[position - 1].area < blob.area)
+    {
+        list.blobs[position] = list.blobs[position - 1];
+        position--;
+    }
+    list.blobs[position] = blob;
+}
+
+//------------------------------------------------------------------------------
+
+void findBlobs(const FrameMask &mask, const float *frame, uint16_t minArea, BlobRegion *regions,
+               uint16_t regionCount, uint16_t *rowLabels, BlobList &list)
+{
+    int cols = mask.cols;
+    uint16_t *previous = rowLabels;
+    uint16_t *current = rowLabels + cols;
+    uint16_t next = 1;
+
+    list.count = 0;
+    list.overflow = false;
+    if (regionCount == 0)
+    {
+        list.overflow = true;
+        return;
+    }
+    memset(previous, 0, cols * sizeof(uint16_t));
+
+    for (int r = 0; r < mask.rows; r++)
+    {
+        memset(current, 0, cols * sizeof(uint16_t));
+        for (uint32_t bits = mask.bits[r]; bits != 0; bits &= bits - 1)
+        {
+            int c = __builtin_ctz(bits);
+            uint16_t index = r * cols + c;
+            float value = frame[index];
+            uint16_t label = 0;
+
+            // left, upper left, up and upper right were visited already
+            uint16_t neighbours[4] = {c > 0 ? current[c - 1] : (uint16_t)0, c > 0 ? previous[c - 1] : (uint16_t)0,
+                                      previous[c], c + 1 < cols ? previous[c + 1] : (uint16_t)0};
+            for (int n = 0; n < 4; n++)
+            {
+                if (neighbours[n] != 0)
+                {
+                    label = label == 0 ? findRoot(regions, neighbours[n]) : join(regions, label, neighbours[n]);
+                }
+            }
+
+            if (label == 0)
+            {
+                if (next == regionCount)
+                {
+                    // only reachable with a workspace smaller than the frame
+                    list.overflow = true;
+                    continue;
+                }
+                label = next++;
+                BlobRegion &region = regions[label];
+                region.parent = label;
+                region.area = 0;
+                region.sumRow = 0;
+                region.sumCol = 0;
+                region.top = r;
+                region.left = c;
+                region.bottom = r;
+                region.right = c;
+                region.peak = value;
+                region.peakIndex = index;
+            }
+
+            addPixel(regions[label], r, c, value, index);
+            current[c] = label;
+        }
+
+        uint16_t *swap = previous;
+        previous = current;
+        current = swap;
+    }
+
+    for (uint16_t label = 1; label < next; label++)
+    {
+        const BlobRegion &region = regions[label];
+        if (region.parent != label || region.area < minArea)
+        {
+            continue;
+        }
+
+        Blob blob;
+        blob.area = region.area;
+        blob.centroidRow = (float)region.sumRow / region.area;
+        blob.centroidCol = (float)region.sumCol / region.area;
+        blob.top = region.top;
+        blob.left = region.left;
+        blob.bottom = region.bottom;
+        blob.right = region.right;
+        blob.peak = region.peak;
+        blob.peakIndex = region.peakIndex;
+        insertBlob(list, blob);
+    }
+}
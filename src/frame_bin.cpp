@@ -0,0 +1,65 @@
+#include "frame_bin.h"
+#include <string.h>
+
+static uint8_t *put16(uint8_t *out, uint16_t value)
+{
+    out[0] = value;
+    out[1] = value >> 8;
+    return out + 2;
+}
+
+static uint8_t *put32(uint8_t *out, uint32_t value)
+{
+    out = put16(out, value);
+    return put16(out, value >> 16);
+}
+
+size_t frameBinEncode(const StoredFrame &frame, const StoredFrame *previous, const char *sensor, uint8_t *out,
+                      size_t size)
+{
+    int count = frame.rows * frame.cols;
+    bool delta = previous != NULL && previous->sequence + 1 == frame.sequence && previous->rows == frame.rows &&
+                 previous->cols == frame.cols;
+    uint8_t *start = out;
+
+    if (size < FRAME_BIN_MAX_BYTES || count > FRAME_BIN_MAX_PIXELS)
+    {
+        return 0;
+    }
+
+    memcpy(out, "TVFB", 4);
+    out[4] = FRAME_BIN_VERSION;
+    out[5] = delta ? FRAME_BIN_DELTA : 0;
+    put16(out + 6, FRAME_BIN_HEADER_SIZE);
+    memset(out + 8, 0, 8);
+    strncpy((char *)out + 8, sensor, 8);
+    out[16] = frame.rows;
+    out[17] = frame.cols;
+    put16(out + 18, FRAME_BIN_SCALE);
+    put32(out + 20, frame.timestamp);
+    put32(out + 24, frame.sequence);
+    put16(out + 28, frame.ta);
+    put16(out + 30, 0);
+    out += FRAME_BIN_HEADER_SIZE;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!delta)
+        {
+            out = put16(out, frame.pixels[i]);
+            continue;
+        }
+
+        // zigzag keeps small negative steps small: 0, -1, 1, -2 -> 0, 1, 2, 3
+        int32_t difference = (int32_t)frame.pixels[i] - previous->pixels[i];
+        uint32_t value = ((uint32_t)difference << 1) ^ (uint32_t)(difference >> 31);
+        while (value >= 0x80)
+        {
+            *out++ = value | 0x80;
+            value >>= 7;
+        }
+        *out++ = value;
+    }
+
+    return out - start;
+}
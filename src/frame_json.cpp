@@ -0,0 +1,217 @@
+#include "frame_json.h"
+#include <math.h>
+#include <string.h>
+
+static_assert(FRAME_JSON_CHUNK_BYTES >= 64, "a chunk must hold the longest key or number");
+
+struct ChunkWriter
+{
+    char buffer[FRAME_JSON_CHUNK_BYTES];
+    size_t used;
+    size_t total;
+    FrameJsonWrite write;
+    void *context;
+};
+
+static void flush(ChunkWriter &writer)
+{
+    if (writer.used != 0)
+    {
+        writer.write(writer.buffer, writer.used, writer.context);
+        writer.total += writer.used;
+        writer.used = 0;
+    }
+}
+
+// Room for length more characters
+static char *reserve(ChunkWriter &writer, size_t length)
+{
+    if (writer.used + length > sizeof(writer.buffer))
+    {
+        flush(writer);
+    }
+    return writer.buffer + writer.used;
+}
+
+static void appendText(ChunkWriter &writer, const char *text)
+{
+    size_t length = strlen(text);
+
+    while (length != 0)
+    {
+        size_t count = length < sizeof(writer.buffer) ? length : sizeof(writer.buffer);
+        memcpy(reserve(writer, count), text, count);
+        writer.used += count;
+        text += count;
+        length -= count;
+    }
+}
+
+static char *formatUnsigned(char *out, uint32_t value)
+{
+    char digits[10];
+    int count = 0;
+
+    do
+    {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+
+    while (count > 0)
+    {
+        *out++ = digits[--count];
+    }
+    return out;
+}
+
+static void appendUnsigned(ChunkWriter &writer, uint32_t value)
+{
+    char *out = reserve(writer, 10);
+    writer.used += formatUnsigned(out, value) - out;
+}
+
+// JSON has no NaN or infinity, ArduinoJson writes them as null as well
+static void appendNumber(ChunkWriter &writer, float value)
+{
+    if (!isfinite(value))
+    {
+        appendText(writer, "null");
+        return;
+    }
+    writer.used += frameJsonNumber(reserve(writer, FRAME_JSON_NUMBER_CHARS), value);
+}
+
+static void appendBool(ChunkWriter &writer, bool value)
+{
+    appendText(writer, value ? "true" : "false");
+}
+
+//------------------------------------------------------------------------------
+
+int frameJsonCenti(char *out, int32_t centi)
+{
+    char *start = out;
+    uint32_t magnitude = centi;
+
+    if (centi < 0)
+    {
+        *out++ = '-';
+        magnitude = -(uint32_t)centi;
+    }
+    out = formatUnsigned(out, magnitude / 100);
+    *out++ = '.';
+    *out++ = '0' + magnitude / 10 % 10;
+    *out++ = '0' + magnitude % 10;
+
+    return out - start;
+}
+
+int frameJsonNumber(char *out, float value)
+{
+    if (isnan(value))
+    {
+        memcpy(out, "nan", 3);
+        return 3;
+    }
+    if (isinf(value))
+    {
+        memcpy(out, value < 0 ? "-inf" : "inf", value < 0 ? 4 : 3);
+        return value < 0 ? 4 : 3;
+    }
+
+    // small negatives print as "-0.00", as dtostrf does
+    if (value < 0)
+    {
+        *out = '-';
+        return 1 + frameJsonNumber(out + 1, -value);
+    }
+    if (value > FRAME_JSON_NUMBER_MAX)
+    {
+        value = FRAME_JSON_NUMBER_MAX;
+    }
+
+    // one rounding step instead of printf's digit loop; half away from zero like dtostrf
+    return frameJsonCenti(out, (int32_t)(value * 100.0f + 0.5f));
+}
+
+//------------------------------------------------------------------------------
+
+size_t frameJsonStream(const char *sensor, int rows, int cols, const int16_t *centi, const FrameSummary &summary,
+                       FrameJsonWrite write, void *context)
+{
+    ChunkWriter writer;
+    int pixels = rows * cols;
+
+    writer.used = 0;
+    writer.total = 0;
+    writer.write = write;
+    writer.context = context;
+
+    appendText(writer, "{\"sensor\":\"");
+    appendText(writer, sensor);
+    appendText(writer, "\",\"rows\":");
+    appendUnsigned(writer, rows);
+    appendText(writer, ",\"cols\":");
+    appendUnsigned(writer, cols);
+    appendText(writer, ",\"data\":\"");
+    for (int i = 0; i < pixels; i++)
+    {
+        char *out = reserve(writer, FRAME_JSON_NUMBER_CHARS + 1);
+        char *start = out;
+
+        if (i != 0)
+        {
+            *out++ = ',';
+        }
+        if (centi[i] == FRAME_JSON_INVALID)
+        {
+            memcpy(out, "nan", 3);
+            out += 3;
+        }
+        else
+        {
+            out += frameJsonCenti(out, centi[i]);
+        }
+        writer.used += out - start;
+    }
+    appendText(writer, "\",\"temp\":");
+    appendNumber(writer, summary.avg);
+    appendText(writer, ",\"avg\":");
+    appendNumber(writer, summary.avg);
+    appendText(writer, ",\"min\":");
+    appendNumber(writer, summary.min);
+    appendText(writer, ",\"max\":");
+    appendNumber(writer, summary.max);
+    appendText(writer, ",\"min_index\":");
+    appendUnsigned(writer, summary.minIndex);
+    appendText(writer, ",\"max_index\":");
+    appendUnsigned(writer, summary.maxIndex);
+    appendText(writer, ",\"overflow\":");
+    appendBool(writer, summary.overflow);
+    appendText(writer, ",\"movingAverageEnabled\":");
+    appendBool(writer, summary.movingAverageEnabled);
+    appendText(writer, ",\"person_detected\":");
+    appendBool(writer, summary.personDetected);
+    appendText(writer, ",\"person_count\":");
+    appendUnsigned(writer, summary.personCount);
+    appendText(writer, ",\"tracks\":[");
+    for (int i = 0; i < summary.trackCount && i < FRAME_JSON_MAX_TRACKS; i++)
+    {
+        appendText(writer, i == 0 ? "{\"id\":" : ",{\"id\":");
+        appendUnsigned(writer, summary.tracks[i].id);
+        appendText(writer, ",\"row\":");
+        appendNumber(writer, summary.tracks[i].row);
+        appendText(writer, ",\"col\":");
+        appendNumber(writer, summary.tracks[i].col);
+        appendText(writer, "}");
+    }
+    appendText(writer, "],\"line_in\":");
+    appendUnsigned(writer, summary.lineIn);
+    appendText(writer, ",\"line_out\":");
+    appendUnsigned(writer, summary.lineOut);
+    appendText(writer, "}");
+    flush(writer);
+
+    return writer.total;
+}
@@ -0,0 +1,165 @@
+#include "frame_mask.h"
+
+static uint32_t columnMask(int cols)
+{
+    return cols >= 32 ? 0xFFFFFFFF : ((uint32_t)1 << cols) - 1;
+}
+
+static uint32_t rowAt(const FrameMask &mask, int r)
+{
+    return r >= 0 && r < mask.rows ? mask.bits[r] : 0;
+}
+
+// Carry-save adder: three one bit values per column into a sum and a carry bit
+static void fullAdd(uint32_t a, uint32_t b, uint32_t c, uint32_t &sum, uint32_t &carry)
+{
+    uint32_t partial = a ^ b;
+    sum = partial ^ c;
+    carry = (a & b) | (partial & c);
+}
+
+// Bit set where the 4 bit counter is >= minimum, compared from the top bit down
+static uint32_t atLeast(const uint32_t *count, int minimum)
+{
+    uint32_t greater = 0;
+    uint32_t equal = 0xFFFFFFFF;
+
+    if (minimum <= 0)
+    {
+        return equal;
+    }
+    if (minimum > 15)
+    {
+        return 0;
+    }
+    for (int i = 3; i >= 0; i--)
+    {
+        if (minimum & (1 << i))
+        {
+            equal &= count[i];
+        }
+        else
+        {
+            greater |= equal & count[i];
+            equal &= ~count[i];
+        }
+    }
+    return greater | equal;
+}
+
+//------------------------------------------------------------------------------
+
+void maskThreshold(FrameMask &mask, const float *frame, int rows, int cols, float threshold)
+{
+    mask.rows = rows;
+    mask.cols = cols;
+    for (int r = 0; r < rows; r++)
+    {
+        uint32_t bits = 0;
+        for (int c = 0; c < cols; c++)
+        {
+            bits |= (uint32_t)(frame[c] > threshold) << c;
+        }
+        mask.bits[r] = bits;
+        frame += cols;
+    }
+}
+
+int maskCount(const FrameMask &mask)
+{
+    int count = 0;
+
+    for (int r = 0; r < mask.rows; r++)
+    {
+        count += __builtin_popcount(mask.bits[r]);
+    }
+    return count;
+}
+
+bool maskAny(const FrameMask &mask)
+{
+    uint32_t any = 0;
+
+    for (int r = 0; r < mask.rows; r++)
+    {
+        any |= mask.bits[r];
+    }
+    return any != 0;
+}
+
+void maskAnd(const FrameMask &a, const FrameMask &b, FrameMask &out)
+{
+    out.rows = a.rows;
+    out.cols = a.cols;
+    for (int r = 0; r < a.rows; r++)
+    {
+        out.bits[r] = a.bits[r] & b.bits[r];
+    }
+}
+
+void maskNeighbours(const FrameMask &mask, int minimum, FrameMask &out)
+{
+    uint32_t columns = columnMask(mask.cols);
+
+    out.rows = mask.rows;
+    out.cols = mask.cols;
+    for (int r = 0; r < mask.rows; r++)
+    {
+        uint32_t above = rowAt(mask, r - 1);
+        uint32_t row = mask.bits[r];
+        uint32_t below = rowAt(mask, r + 1);
+        uint32_t count[4];
+        uint32_t ones[3];
+        uint32_t twos[4];
+        uint32_t four;
+        uint32_t fourCarry;
+
+        // 8 neighbour bits -> 4 bit count per column, 26 word operations per row
+        fullAdd((above << 1) & columns, above, above >> 1, ones[0], twos[0]);
+        fullAdd((below << 1) & columns, below, below >> 1, ones[1], twos[1]);
+        ones[2] = ((row << 1) & columns) ^ (row >> 1);
+        twos[2] = ((row << 1) & columns) & (row >> 1);
+        fullAdd(ones[0], ones[1], ones[2], count[0], twos[3]);
+        fullAdd(twos[0], twos[1], twos[2], count[1], four);
+        fourCarry = count[1] & twos[3];
+        count[1] ^= twos[3];
+        count[2] = four ^ fourCarry;
+        count[3] = four & fourCarry;
+        out.bits[r] = atLeast(count, minimum) & columns;
+    }
+}
+
+void maskDilate(const FrameMask &mask, FrameMask &out)
+{
+    uint32_t columns = columnMask(mask.cols);
+    uint32_t spread[FRAME_MASK_MAX_ROWS];
+
+    for (int r = 0; r < mask.rows; r++)
+    {
+        uint32_t row = mask.bits[r];
+        spread[r] = (row | row << 1 | row >> 1) & columns;
+    }
+    out.rows = mask.rows;
+    out.cols = mask.cols;
+    for (int r = 0; r < mask.rows; r++)
+    {
+        out.bits[r] = spread[r] | (r > 0 ? spread[r - 1] : 0) | (r + 1 < mask.rows ? spread[r + 1] : 0);
+    }
+}
+
+void maskErode(const FrameMask &mask, FrameMask &out)
+{
+    uint32_t narrowed[FRAME_MASK_MAX_ROWS];
+
+    for (int r = 0; r < mask.rows; r++)
+    {
+        uint32_t row = mask.bits[r];
+        narrowed[r] = row & (row << 1) & (row >> 1);
+    }
+    out.rows = mask.rows;
+    out.cols = mask.cols;
+    for (int r = 0; r < mask.rows; r++)
+    {
+        out.bits[r] = narrowed[r] & (r > 0 ? narrowed[r - 1] : 0) & (r + 1 < mask.rows ? narrowed[r + 1] : 0);
+    }
+}
@@ -0,0 +1,85 @@
+#include "frame_store.h"
+#include <math.h>
+#include <string.h>
+
+int16_t frameStoreCenti(float value)
+{
+    if (isnan(value))
+    {
+        return FRAME_STORE_INVALID;
+    }
+
+    value = value * 100;
+    if (value >= INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (value <= INT16_MIN + 1)
+    {
+        return INT16_MIN + 1;
+    }
+    return (int16_t)lroundf(value);
+}
+
+StoredFrame *frameStoreBegin(FrameStore &store)
+{
+    uint32_t sequence = store.latest.load(std::memory_order_relaxed) + 1;
+    FrameStoreSlot &slot = store.slots[sequence & 1];
+
+    // only the producer changes versions, a plain load and store is enough
+    slot.version.store(slot.version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.frame.sequence = sequence;
+
+    return &slot.frame;
+}
+
+void frameStorePublish(FrameStore &store)
+{
+    uint32_t sequence = store.latest.load(std::memory_order_relaxed) + 1;
+    FrameStoreSlot &slot = store.slots[sequence & 1];
+
+    slot.version.store(slot.version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    store.latest.store(sequence, std::memory_order_release);
+}
+
+bool frameStoreRead(const FrameStore &store, uint32_t sequence, StoredFrame &frame)
+{
+    for (int retry = 0; retry < FRAME_STORE_READ_RETRIES; retry++)
+    {
+        uint32_t wanted = sequence != 0 ? sequence : store.latest.load(std::memory_order_acquire);
+        if (wanted == 0)
+        {
+            return false;
+        }
+
+        const FrameStoreSlot &slot = store.slots[wanted & 1];
+        uint32_t version = slot.version.load(std::memory_order_acquire);
+        if (version & 1)
+        {
+            if (sequence != 0)
+            {
+                return false; // being replaced by a newer frame
+            }
+            continue;
+        }
+
+        memcpy(&frame, &slot.frame, sizeof(frame));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != version)
+        {
+            continue;
+        }
+        if (frame.sequence == wanted)
+        {
+            return true;
+        }
+        // the producer moved two frames on; the latest is in the slot read next
+        if (sequence != 0)
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
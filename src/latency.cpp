@@ -0,0 +1,56 @@
+#include "latency.h"
+
+void latencyRecord(LatencyHistogram &histogram, uint32_t us)
+{
+    int bucket = us == 0 ? 0 : 31 - __builtin_clz(us);
+    if (bucket >= LATENCY_BUCKETS)
+    {
+        bucket = LATENCY_BUCKETS - 1;
+    }
+
+    histogram.buckets[bucket]++;
+    histogram.count++;
+    histogram.totalUs += us;
+    if (us > histogram.maxUs)
+    {
+        histogram.maxUs = us;
+    }
+}
+
+void latencyReset(LatencyHistogram &histogram)
+{
+    memset(&histogram, 0, sizeof(histogram));
+}
+
+// {"count":..,"avg_us":..,"max_us":..,"buckets_us":{"<lower bound>":count,..}}, empty buckets left out
+String latencyToJson(const LatencyHistogram &histogram)
+{
+    String json = "{\"count\":";
+    json += histogram.count;
+    json += ",\"avg_us\":";
+    json += histogram.count ? (uint32_t)(histogram.totalUs / histogram.count) : 0;
+    json += ",\"max_us\":";
+    json += histogram.maxUs;
+    json += ",\"buckets_us\":{";
+
+    bool first = true;
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        if (histogram.buckets[i] == 0)
+        {
+            continue;
+        }
+        if (!first)
+        {
+            json += ",";
+        }
+        first = false;
+        json += "\"";
+        json += i == 0 ? 0 : (1UL << i);
+        json += "\":";
+        json += histogram.buckets[i];
+    }
+    json += "}}";
+
+    return json;
+}
@@ -1,9 +1,20 @@
 #include <ESP8266WebServer.h>
 #include <MLX90641_API.h>
+#include <MLX90641_Bench.h>
+#include <MLX90641_Cache.h>
+#include <MLX90641_Frame.h>
 #include <MLX90641_I2C_Driver.h>
-#include <ArduinoJson.h>
+#include <LittleFS.h>
 #include <Wire.h>
 #include <WiFiManager.h>
+#include "background.h"
+#include "blobs.h"
+#include "frame_bin.h"
+#include "frame_json.h"
+#include "frame_store.h"
+#include "latency.h"
+#include "temporal_filter.h"
+#include "tracker.h"
 
 #define ESP8266_DRD_USE_RTC false
 #define ESP_DRD_USE_LITTLEFS true
@@ -17,171 +28,192 @@ const byte MLX90641_address = 0x33; // Default 7-bit unshifted address of the ML
 // camera resolution
 const int rows = 16;
 const int cols = 12;
-float frame[rows][cols];
 const int total_pixels = rows * cols;
+// frame[row * cols + col]: the To kernel writes sensor column n to frame row n, so the
+// assembler slots already hold the frame and frame points at the latest one
+const MLX90641_Layout frameLayout = {1, cols};
+const float *frame = NULL;
 // camera frame
-float MLX90641To[total_pixels];
-uint16_t eeMLX90641[832];
+MLX90641_FrameAssembler MLX90641Assembler;
+MLX90641_Acquisition MLX90641Acquisition;
+bool acquisitionActive = false;
+unsigned long lastFrameMillis = 0;
+bool outputPending = false;
+#ifdef MLX90641_FIXED_POINT
+int16_t MLX90641ToQ[total_pixels]; // centi-degrees
+#endif
 uint16_t MLX90641Frame[242];
+// last completed sub-page for /bench, MLX90641Frame is overwritten while a read is in flight
+uint16_t MLX90641BenchFrame[242];
+bool benchFrameValid = false;
 paramsMLX90641 MLX90641;
+#ifndef MLX90641_FIXED_POINT
+// float lanes for CalculateToCompiled; the fixed point kernel reads params only
+calibMLX90641 MLX90641Calib;
+#endif
+// gathered by the To kernel while it compensates a sub-page, so it describes the latest frame
+MLX90641_FrameStats MLX90641Stats;
+const char *calibrationCachePath = "/mlx90641.cal";
+// boot timing in ms since reset, reported by /stats
+unsigned long calibrationMillis = 0;
+unsigned long firstFrameMillis = 0;
+bool calibrationCached = false;
 
 // person detection values - can be configured via request params
 // http://192.168.1.123/update?personThresholdLow=30&personThresholdHigh=40&humanThreshold=2&personTempDecrease=2
 int humanThreshold = 3;
-float tempKoef = 1.6;
 float minHumanTemp = 25.5;
-int minNeighboursCount = 2;
-int delayOutputComputation = 8;
-long mainLoopCounter = delayOutputComputation;
+int minNeighboursCount = 2; // blobs need at least minNeighboursCount + 1 pixels
+int delayOutputComputation = 8; // pause between computed frames in 100 ms steps
+
+// denoising between compensation and detection, e.g.
+// http://192.168.1.123/update?filter=kalman&filterQ=0.01&filterR=0.04&filterGate=4
+// or filter=average&filterWindow=4, filter=ewma&filterAlpha=0.3, filter=off
+TemporalFilter temporalFilter;
+TemporalFilterRange filteredRange;
+
+// pixels warmer than their learned background, e.g.
+// http://192.168.1.123/update?backgroundZ=3&backgroundAlpha=0.02&backgroundReset=1
+BackgroundModel<rows, cols> background;
+FrameMask hotMask;
+BlobWorkspace<rows, cols> blobWorkspace;
+BlobList blobs;
+// people of the latest frame followed across frames, configured via /update
+// e.g. http://192.168.1.123/update?countLine=8&trackDistance=3&trackConfirm=2&trackDrop=3
+BlobList people;
+Tracker tracker;
 
 // ESP server settgins
 ESP8266WebServer server(80);
 DoubleResetDetector *drd;
 
-String output;
-
-float getPixel(int x, int y)
+// computed frames published by getRaw(), handlers only read snapshots of them
+FrameStore frameStore;
+uint8_t frameBinOutput[FRAME_BIN_MAX_BYTES];
+// sensor temperature of the latest sub-page
+float ambientTemperature = 0;
+
+// request service time (wait for the next handleClient plus handler) and the gap between handleClient calls
+LatencyHistogram requestLatency;
+LatencyHistogram loopLatency;
+LatencyHistogram rawStreamLatency;
+LatencyHistogram rawFirstChunkLatency;
+LatencyHistogram trackerLatency;
+LatencyHistogram filterLatency;
+unsigned long lastClientPoll = 0;
+uint32_t statsFramesBase = 0;
+
+// Frame complete event of the assembler; the slot is not written again until the frame after next
+void onCameraFrame(const float *to, uint8_t subPage, void *context)
 {
-    if (x < rows && x >= 0 && y < cols && y >= 0)
+    if (firstFrameMillis == 0)
     {
-        return frame[x][y];
+        firstFrameMillis = millis();
     }
-    return (float)0.0;
+    Serial.print("Temp frame from sub-page ");
+    Serial.println(subPage);
+    frame = to;
 }
 
-int getNeighboursCount(int r, int c, float threashold)
+// Compensates the sub-page in MLX90641Frame into the assembler; returns true when the frame is complete
+bool compensateCameraFrame()
 {
-    int pixelsExceededPersonThreshold = 0;
+    float *to = MLX90641_FrameBegin(&MLX90641Assembler, MLX90641Frame);
+#ifdef MLX90641_FIXED_POINT
+    int32_t vdd = MLX90641_GetVddQ(MLX90641Frame, &MLX90641);
+    Serial.print("vdd (mV): ");
+    Serial.println((long)((vdd * 1000LL) >> 20));
 
-    if (getPixel(r + 1, c - 1) > threashold)
-    {
-        pixelsExceededPersonThreshold++;
-    }
-    if (getPixel(r + 1, c) > threashold)
-    {
-        pixelsExceededPersonThreshold++;
-    }
-    if (getPixel(r + 1, c + 1) > threashold)
-    {
-        pixelsExceededPersonThreshold++;
-    }
-    if (getPixel(r, c + 1) > threashold)
-    {
-        pixelsExceededPersonThreshold++;
-    }
-    if (getPixel(r, c - 1) > threashold)
-    {
-        pixelsExceededPersonThreshold++;
-    }
-    if (getPixel(r - 1, c - 1) > threashold)
+    int32_t Ta = MLX90641_GetTaQ(MLX90641Frame, &MLX90641);
+    ambientTemperature = Ta / 65536.0f;
+
+    int32_t tr = Ta - (TA_SHIFT << 16); // Reflected temperature based on the sensor ambient temperature
+    uint16_t emissivity = 31130;         // 0.95 in Q15
+
+    MLX90641_CalculateToQ(MLX90641Frame, &MLX90641, emissivity, tr, MLX90641ToQ, &frameLayout, &MLX90641Stats);
+    for (int i = 0; i < total_pixels; i++)
     {
-        pixelsExceededPersonThreshold++;
+        to[i] = MLX90641ToQ[i] / 100.0f;
     }
-    if (getPixel(r - 1, c) > threashold)
+#else
+    float vdd = MLX90641_GetVdd(MLX90641Frame, &MLX90641);
+    Serial.print("vdd: ");
+    Serial.println(vdd);
+
+    float Ta = MLX90641_GetTa(MLX90641Frame, &MLX90641);
+    ambientTemperature = Ta;
+
+    float tr = Ta - TA_SHIFT; // Reflected temperature based on the sensor ambient temperature
+    float emissivity = 0.95;
+
+    MLX90641_CalculateToCompiled(MLX90641Frame, &MLX90641, &MLX90641Calib, emissivity, tr, to, &frameLayout,
+                                 &MLX90641Stats);
+#endif
+    return MLX90641_FrameEnd(&MLX90641Assembler);
+}
+
+// Advances the frame acquisition by at most one register access so the web server is never blocked
+// by the sensor. Each sub-page is compensated once and is a displayed frame on its own.
+void pollCamera()
+{
+    if (!acquisitionActive)
     {
-        pixelsExceededPersonThreshold++;
+        if (millis() - lastFrameMillis < (unsigned long)delayOutputComputation * 100)
+        {
+            return;
+        }
+        MLX90641_StartFrameData(&MLX90641Acquisition, MLX90641_address, MLX90641Frame);
+        acquisitionActive = true;
+        return;
     }
-    if (getPixel(r - 1, c + 1) > threashold)
+
+    if (MLX90641_PollFrameData(&MLX90641Acquisition) == 0)
     {
-        pixelsExceededPersonThreshold++;
+        return;
     }
-    return pixelsExceededPersonThreshold;
-}
+    acquisitionActive = false;
 
-void refreshCameraTempsFrame()
-{
-    Serial.println("getRaw called - Starting MLX90641 Frame computation");
-    for (byte x = 0; x < 2; x++)
+    int status = MLX90641_CompleteFrameData(&MLX90641Acquisition);
+    if (status < 0)
     {
-        int status = MLX90641_GetFrameData(MLX90641_address, MLX90641Frame);
         Serial.print("Frame data status: ");
         Serial.println(status);
-
-        float vdd = MLX90641_GetVdd(MLX90641Frame, &MLX90641);
-        Serial.print("vdd: ");
-        Serial.println(vdd);
-
-        float Ta = MLX90641_GetTa(MLX90641Frame, &MLX90641);
-
-        float tr = Ta - TA_SHIFT; // Reflected temperature based on the sensor ambient temperature
-        float emissivity = 0.95;
-
-        MLX90641_CalculateTo(MLX90641Frame, &MLX90641, emissivity, tr, MLX90641To);
+        return;
     }
-    Serial.println("Starting MLX90641 Frame computation finished");
-
-    // ####################################################################################################################
+    memcpy(MLX90641BenchFrame, MLX90641Frame, sizeof(MLX90641BenchFrame));
+    benchFrameValid = true;
 
-    Serial.println("Starting temp frame construction");
-    int col = 0;
-    int row = 0;
-    for (int i = 0; i < total_pixels; i++)
+    if (compensateCameraFrame())
     {
-        frame[row][col] = MLX90641To[i];
-
-        if (row + 1 == rows)
-        {
-            row = 0;
-            col++;
-        }
-        else
-        {
-            row++;
-        }
+        lastFrameMillis = millis();
+        outputPending = true;
     }
-    Serial.println("Temp frame construction finished");
 }
 
-void getRaw(int humanThreshold, float tempKoef)
+void getRaw(int humanThreshold)
 {
     Serial.println("Starting payload construction");
 
-    // std::map<int, int> tempCountMap = {};
-    float avgTemp = 0;
-    float min = 0;
-    float max = 0;
-    unsigned char min_index = 0;
-    unsigned char max_index = 0;
-    String data;
-    for (int r = 0; r < rows; r++)
+    unsigned long filterStart = micros();
+    const float *filtered = temporalFilterApply(temporalFilter, frame, total_pixels, filteredRange);
+    latencyRecord(filterLatency, micros() - filterStart);
+    bool filterActive = filtered != frame;
+
+    // no pass over the frame: the statistics come from the compensation or the filter loop
+    const MLX90641_FrameStats &stats = MLX90641Stats;
+    float avgTemp = stats.count != 0 ? stats.sum / 100.0f / stats.count : 0;
+    float min = stats.min / 100.0f;
+    float max = stats.max / 100.0f;
+    unsigned char min_index = stats.argMin;
+    unsigned char max_index = stats.argMax;
+    if (filterActive)
     {
-        for (int c = 0; c < cols; c++)
-        {
-            int i = r + c * rows;
-            float pixel_temperature = getPixel(r, c);
-            avgTemp += pixel_temperature / total_pixels;
-
-            if (i == 0 || pixel_temperature > max)
-            {
-                max = pixel_temperature;
-                max_index = i;
-            }
-            if (i == 0 || pixel_temperature < min)
-            {
-                min = pixel_temperature;
-                min_index = i;
-            }
-
-            data.concat(String(pixel_temperature, 2));
-
-            if (i < total_pixels - 1)
-            {
-                data.concat(",");
-            }
-
-            // https://en.cppreference.com/w/cpp/container/map/find
-            // int intTemp = static_cast<int>(pixel_temperature);
-            // if (auto search = tempCountMap.find(intTemp); search != tempCountMap.end())
-            // {
-            //     // found
-            //     tempCountMap[intTemp]++;
-            // }
-            // else
-            // {
-            //     // not found
-            //     tempCountMap[intTemp] = 1;
-            // }
-        }
+        // frame index to the sensor order the indices are reported in
+        avgTemp = filteredRange.count != 0 ? filteredRange.sum / filteredRange.count : 0;
+        min = filteredRange.min;
+        max = filteredRange.max;
+        min_index = filteredRange.argMin % cols * rows + filteredRange.argMin / cols;
+        max_index = filteredRange.argMax % cols * rows + filteredRange.argMax / cols;
     }
 
     Serial.println("Payload construction finished");
@@ -190,19 +222,25 @@ void getRaw(int humanThreshold, float tempKoef)
 
     Serial.println("Person detection started");
 
-    const float tempThreshold = avgTemp + ((avgTemp - min) * tempKoef);
-    int tempAboveThresholdCount = 0;
-    for (int r = 0; r < rows; r++)
+    // a person is one connected warm region of at least humanThreshold pixels that reaches minHumanTemp
+    backgroundUpdate(background, filtered, rows, cols, hotMask);
+    findBlobs(hotMask, filtered, minNeighboursCount + 1, blobWorkspace, blobs);
+    people.count = 0;
+    people.overflow = blobs.overflow;
+    for (int i = 0; i < blobs.count; i++)
     {
-        for (int c = 0; c < cols; c++) // same cycle as above
+        if (blobs.blobs[i].area >= humanThreshold && blobs.blobs[i].peak >= minHumanTemp)
         {
-            float pixel_temperature = getPixel(r, c);
-            if (tempThreshold < pixel_temperature && getNeighboursCount(r, c, tempThreshold) >= minNeighboursCount)
-            {
-                tempAboveThresholdCount++;
-            }
+            people.blobs[people.count++] = blobs.blobs[i];
         }
     }
+    bool personDetected = people.count > 0;
+    Serial.print("Blobs: ");
+    Serial.println(blobs.count);
+
+    unsigned long trackStart = micros();
+    trackerUpdate(tracker, people);
+    latencyRecord(trackerLatency, micros() - trackStart);
 
     Serial.println("Person detection finished");
 
@@ -210,44 +248,71 @@ void getRaw(int humanThreshold, float tempKoef)
 
     Serial.println("Start building response payload");
 
-    String new_output;
-    StaticJsonDocument<1024> doc;
-
-    doc["sensor"] = "MLX90641";
-    doc["rows"] = rows;
-    doc["cols"] = cols;
-    doc["data"] = data.c_str();
-    doc["temp"] = avgTemp;
-    doc["avg"] = avgTemp;
-    doc["min"] = min;
-    doc["max"] = max;
-    doc["min_index"] = min_index;
-    doc["max_index"] = max_index;
-    doc["overflow"] = false;
-    doc["movingAverageEnabled"] = false;
-    doc["person_detected"] = tempAboveThresholdCount >= humanThreshold && max >= minHumanTemp;
-
-    // std::string tempCountMapCsv = "";
-    // for (auto it = tempCountMap.cbegin(); it != tempCountMap.cend(); it++)
-    // {
-    //     std::string convrt = std::to_string(it->second);
-    //     tempCountMapCsv += (it->first) + ":" + (convrt) + ", ";
-    // }
-    // doc["tempCountMap"] = tempCountMapCsv.substr(0, tempCountMapCsv.size() - 2);
+    StoredFrame *stored = frameStoreBegin(frameStore);
+    FrameSummary &summary = stored->summary;
+
+    summary.avg = avgTemp;
+    summary.min = min;
+    summary.max = max;
+    summary.minIndex = min_index;
+    summary.maxIndex = max_index;
+    summary.overflow = false;
+    summary.movingAverageEnabled = filterActive;
+    summary.personDetected = personDetected;
+    summary.personCount = trackerCount(tracker);
+    summary.trackCount = 0;
+    for (int t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        const Track &track = tracker.tracks[t];
+        if (track.id != 0 && track.confirmed && summary.trackCount < FRAME_JSON_MAX_TRACKS)
+        {
+            FrameTrack &output = summary.tracks[summary.trackCount++];
+            output.id = track.id;
+            output.row = track.row;
+            output.col = track.col;
+        }
+    }
+    summary.lineIn = tracker.lineIn;
+    summary.lineOut = tracker.lineOut;
 
     Serial.println("output serializing");
-    serializeJson(doc, new_output);
+    // frame is stored row by row, the order /raw and /frame.bin list the pixels in
+    stored->timestamp = lastFrameMillis;
+    stored->rows = rows;
+    stored->cols = cols;
+    stored->ta = frameStoreCenti(ambientTemperature);
+    for (int i = 0; i < total_pixels; i++)
+    {
+        stored->pixels[i] = frameStoreCenti(filtered[i]);
+    }
+    frameStorePublish(frameStore);
 
-    output = new_output;
     Serial.println("get raw finished. New output computed");
 }
 
+// Service time of the request being handled, measured from the previous handleClient call
+void recordRequest()
+{
+    latencyRecord(requestLatency, micros() - lastClientPoll);
+}
+
 void updateProperties()
 {
     Serial.print("updateProperties called - argument parsing. URL: ");
     String uri = server.uri(); // Get paths // https://stackoverflow.com/questions/69142021/grab-full-url-from-esp8266webserver
     Serial.println(uri);
 
+#ifdef MLX90641_FIXED_POINT
+    // the fixed point To path has no fast mode, refuse the request instead of echoing a setting that does nothing
+    if (server.hasArg("fastToError"))
+    {
+        Serial.println("fastToError rejected: not available in the fixed point build");
+        server.send(400, "text/plain", "fastToError is not available in the fixed point build");
+        recordRequest();
+        return;
+    }
+#endif
+
     // https://forum.arduino.cc/t/esp8266-webserver-handling-multiple-requests/607950/4
     // https://forum.arduino.cc/t/is-this-the-best-way-to-get-data-from-a-http-request/678197/12
     String argsString = "{";
@@ -273,13 +338,27 @@ void updateProperties()
             humanThreshold = atoi(argValue.c_str());
             Serial.println(humanThreshold);
         }
-        else if (argName == "tempKoef")
+        else if (argName == "backgroundZ")
+        {
+            Serial.print("Changing backgroundZ (");
+            Serial.print(background.state.config.zThreshold);
+            Serial.print(") to: ");
+            background.state.config.zThreshold = atof(argValue.c_str());
+            Serial.println(background.state.config.zThreshold);
+        }
+        else if (argName == "backgroundAlpha")
         {
-            Serial.print("Changing tempKoef (");
-            Serial.print(tempKoef);
+            Serial.print("Changing backgroundAlpha (");
+            Serial.print(background.state.config.alpha, 4);
             Serial.print(") to: ");
-            tempKoef = atof(argValue.c_str());
-            Serial.println(tempKoef);
+            background.state.config.alpha = atof(argValue.c_str());
+            Serial.println(background.state.config.alpha, 4);
+        }
+        else if (argName == "backgroundReset")
+        {
+            // learn the scene again, e.g. after the sensor was moved
+            Serial.println("Resetting background");
+            backgroundReset(background);
         }
         else if (argName == "minHumanTemp")
         {
@@ -297,6 +376,143 @@ void updateProperties()
             minNeighboursCount = atof(argValue.c_str());
             Serial.println(minNeighboursCount);
         }
+#ifndef MLX90641_FIXED_POINT
+        else if (argName == "fastToError")
+        {
+            Serial.print("Changing fastToError (");
+            Serial.print(MLX90641_GetFastToError(), 4);
+            Serial.print(") to: ");
+            MLX90641_SetFastTo(atof(argValue.c_str()));
+            Serial.println(MLX90641_GetFastToError(), 4);
+        }
+#endif
+        else if (argName == "i2cTransferBytes")
+        {
+            Serial.print("Changing i2cTransferBytes (");
+            Serial.print(MLX90641_I2CGetTransferSize());
+            Serial.print(") to: ");
+            Serial.println(MLX90641_I2CSetTransferSize(atoi(argValue.c_str())));
+        }
+        else if (argName == "readGap")
+        {
+            Serial.print("Changing readGap to: ");
+            MLX90641_SetReadGap(atoi(argValue.c_str()));
+            Serial.println(argValue);
+        }
+        else if (argName == "auxRefresh")
+        {
+            Serial.print("Changing auxRefresh to: ");
+            MLX90641_SetAuxRefresh(atoi(argValue.c_str()));
+            Serial.println(argValue);
+        }
+        else if (argName == "trackDistance")
+        {
+            Serial.print("Changing trackDistance (");
+            Serial.print(tracker.config.maxDistance);
+            Serial.print(") to: ");
+            tracker.config.maxDistance = atof(argValue.c_str());
+            Serial.println(tracker.config.maxDistance);
+        }
+        else if (argName == "trackConfirm")
+        {
+            Serial.print("Changing trackConfirm (");
+            Serial.print(tracker.config.confirmFrames);
+            Serial.print(") to: ");
+            tracker.config.confirmFrames = atoi(argValue.c_str());
+            Serial.println(tracker.config.confirmFrames);
+        }
+        else if (argName == "trackDrop")
+        {
+            Serial.print("Changing trackDrop (");
+            Serial.print(tracker.config.dropFrames);
+            Serial.print(") to: ");
+            tracker.config.dropFrames = atoi(argValue.c_str());
+            Serial.println(tracker.config.dropFrames);
+        }
+        else if (argName == "countLine")
+        {
+            // row of the counting line, negative disables it; the counters restart
+            Serial.print("Changing countLine (");
+            Serial.print(tracker.config.lineRow);
+            Serial.print(") to: ");
+            tracker.config.lineRow = atof(argValue.c_str());
+            Serial.println(tracker.config.lineRow);
+            tracker.lineIn = 0;
+            tracker.lineOut = 0;
+            for (int t = 0; t < TRACKER_MAX_TRACKS; t++)
+            {
+                tracker.tracks[t].side = 0;
+            }
+        }
+        else if (argName == "filter")
+        {
+            int kind = temporalFilterParse(argValue.c_str());
+            Serial.print("Changing filter (");
+            Serial.print(temporalFilterName(temporalFilter.state.config.kind));
+            Serial.print(") to: ");
+            if (kind >= 0)
+            {
+                temporalFilter.state.config.kind = kind;
+                temporalFilter.state.filled = 0;
+            }
+            Serial.println(temporalFilterName(temporalFilter.state.config.kind));
+        }
+        else if (argName == "filterWindow")
+        {
+            Serial.print("Changing filterWindow (");
+            Serial.print(temporalFilter.state.config.window);
+            Serial.print(") to: ");
+            temporalFilter.state.config.window = atoi(argValue.c_str());
+            Serial.println(temporalFilter.state.config.window);
+            temporalFilter.state.filled = 0;
+        }
+        else if (argName == "filterAlpha")
+        {
+            Serial.print("Changing filterAlpha (");
+            Serial.print(temporalFilter.state.config.alpha);
+            Serial.print(") to: ");
+            temporalFilter.state.config.alpha = atof(argValue.c_str());
+            Serial.println(temporalFilter.state.config.alpha);
+        }
+        else if (argName == "filterQ")
+        {
+            Serial.print("Changing filterQ (");
+            Serial.print(temporalFilter.state.config.processNoise, 4);
+            Serial.print(") to: ");
+            temporalFilter.state.config.processNoise = atof(argValue.c_str());
+            Serial.println(temporalFilter.state.config.processNoise, 4);
+        }
+        else if (argName == "filterR")
+        {
+            Serial.print("Changing filterR (");
+            Serial.print(temporalFilter.state.config.measurementNoise, 4);
+            Serial.print(") to: ");
+            temporalFilter.state.config.measurementNoise = atof(argValue.c_str());
+            Serial.println(temporalFilter.state.config.measurementNoise, 4);
+        }
+        else if (argName == "filterGate")
+        {
+            Serial.print("Changing filterGate (");
+            Serial.print(temporalFilter.state.config.gate);
+            Serial.print(") to: ");
+            temporalFilter.state.config.gate = atof(argValue.c_str());
+            Serial.println(temporalFilter.state.config.gate);
+        }
+        else if (argName == "refreshRate" || argName == "resolution")
+        {
+            // e.g. refreshRate=5 (16 Hz) with resolution=1 (17 bit) and a filter to make up for the noise
+            int value = atoi(argValue.c_str());
+            int status = argName == "refreshRate" ? MLX90641_SetRefreshRate(MLX90641_address, value)
+                                                  : MLX90641_SetResolution(MLX90641_address, value);
+            Serial.print("Changing ");
+            Serial.print(argName);
+            Serial.print(" status: ");
+            Serial.println(status);
+            // frames in flight were taken with the old setting
+            acquisitionActive = false;
+            MLX90641_FrameReset(&MLX90641Assembler);
+            temporalFilter.state.filled = 0;
+        }
         else if (argName == "delayOutputComputation")
         {
             Serial.print("Changing delayOutputComputation (");
@@ -310,16 +526,201 @@ void updateProperties()
     Serial.println(argsString);
 
     server.send(200, "application/json", argsString.c_str());
+    recordRequest();
     Serial.println("updateProperties called - arguments parsed");
 }
 
+struct RawStream
+{
+    unsigned long start;
+    bool firstChunkSent;
+};
+
+void sendRawChunk(const char *data, size_t length, void *context)
+{
+    RawStream *stream = (RawStream *)context;
+    if (!stream->firstChunkSent)
+    {
+        stream->firstChunkSent = true;
+        latencyRecord(rawFirstChunkLatency, micros() - stream->start);
+    }
+    server.sendContent(data, length);
+}
+
+// Streams the payload with chunked transfer encoding, only one FRAME_JSON_CHUNK_BYTES piece exists at a time
 void sendRaw()
 {
     Serial.println("sendRaw called");
-    server.send(200, "application/json", output.c_str());
+    StoredFrame snapshot;
+    if (!frameStoreRead(frameStore, 0, snapshot))
+    {
+        server.send(200, "application/json", "{}");
+        recordRequest();
+        return;
+    }
+
+    RawStream stream = {micros(), false};
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+    frameJsonStream("MLX90641", snapshot.rows, snapshot.cols, snapshot.pixels, snapshot.summary, sendRawChunk,
+                    &stream);
+    server.sendContent("");
+    latencyRecord(rawStreamLatency, micros() - stream.start);
+    recordRequest();
     Serial.println("sendRaw finished - data sent");
 }
 
+// Latest frame in the binary format of frame_bin.h, e.g. http://192.168.1.123/frame.bin?base=41
+// returns a delta against frame 41 when that is the previous frame, otherwise absolute pixels
+void sendFrameBin()
+{
+    uint32_t base = server.hasArg("base") ? strtoul(server.arg("base").c_str(), NULL, 10) : 0;
+    StoredFrame latest;
+    StoredFrame previous;
+
+    if (!frameStoreRead(frameStore, 0, latest))
+    {
+        server.send(503, "text/plain", "No frame yet");
+        recordRequest();
+        return;
+    }
+
+    bool delta = base != 0 && base + 1 == latest.sequence && frameStoreRead(frameStore, base, previous);
+    size_t length = frameBinEncode(latest, delta ? &previous : NULL, "MLX90641", frameBinOutput, sizeof(frameBinOutput));
+    server.send(200, "application/octet-stream", (const char *)frameBinOutput, length);
+    recordRequest();
+}
+
+// Benchmarks the compensation math on this board against the calibration extracted at boot
+// and the last captured sub-page, e.g. http://192.168.1.123/bench?iterations=4
+// Acquisition pauses while it runs; the benchmark yields so WiFi and the watchdog are served.
+void sendBench()
+{
+    Serial.println("sendBench called");
+    int iterations = 4;
+    if (server.hasArg("iterations"))
+    {
+        iterations = constrain(atoi(server.arg("iterations").c_str()), 1, 16);
+    }
+
+    if (!benchFrameValid)
+    {
+        server.send(503, "text/plain", "No frame captured yet");
+        recordRequest();
+        return;
+    }
+
+    const size_t reportSize = 2560;
+    char *report = (char *)malloc(reportSize);
+    if (report == NULL)
+    {
+        server.send(500, "text/plain", "Benchmark setup failed");
+        recordRequest();
+        return;
+    }
+
+    // no EEPROM read in the handler: the dump functions are skipped and the frame
+    // functions run against the live parameters, so only the result buffers are allocated
+    // (plus the float calibration in the fixed point build, which does not keep one)
+#ifdef MLX90641_FIXED_POINT
+    MLX90641_BenchCorpus corpus = {NULL, 0, MLX90641BenchFrame, 1, (uint16_t)iterations, &MLX90641, NULL};
+#else
+    MLX90641_BenchCorpus corpus = {NULL, 0, MLX90641BenchFrame, 1, (uint16_t)iterations, &MLX90641, &MLX90641Calib};
+#endif
+    if (MLX90641_Bench(&corpus, report, reportSize) < 0)
+    {
+        server.send(500, "text/plain", "Benchmark failed");
+    }
+    else
+    {
+        server.send(200, "application/json", report);
+    }
+
+    free(report);
+    recordRequest();
+    Serial.println("sendBench finished - data sent");
+}
+
+// Latency histograms, e.g. http://192.168.1.123/stats?reset=1 to start a new measurement
+void sendStats()
+{
+    String stats = "{\"request\":";
+    stats += latencyToJson(requestLatency);
+    stats += ",\"loop\":";
+    stats += latencyToJson(loopLatency);
+    stats += ",\"raw_stream\":";
+    stats += latencyToJson(rawStreamLatency);
+    stats += ",\"raw_first_chunk\":";
+    stats += latencyToJson(rawFirstChunkLatency);
+    stats += ",\"tracker\":";
+    stats += latencyToJson(trackerLatency);
+    stats += ",\"filter\":{\"kind\":\"";
+    stats += temporalFilterName(temporalFilter.state.config.kind);
+    stats += "\",\"bytes\":";
+    stats += temporalFilterBytes(temporalFilter);
+    stats += ",\"latency\":";
+    stats += latencyToJson(filterLatency);
+    stats += "}";
+    stats += ",\"heap\":{\"free\":";
+    stats += ESP.getFreeHeap();
+    stats += ",\"max_block\":";
+    stats += ESP.getMaxFreeBlockSize();
+    stats += ",\"fragmentation\":";
+    stats += ESP.getHeapFragmentation();
+    stats += "}";
+    stats += ",\"frames\":";
+    stats += MLX90641Assembler.frames;
+    stats += ",\"histogram\":{\"low\":";
+    stats += String(MLX90641Stats.histogramLow / 100.0f, 2);
+    stats += ",\"width\":";
+    stats += String(MLX90641Stats.histogramWidth / 100.0f, 2);
+    stats += ",\"counts\":[";
+    for (int i = 0; i < MLX90641_HISTOGRAM_BINS; i++)
+    {
+        if (i > 0)
+        {
+            stats += ",";
+        }
+        stats += MLX90641Stats.histogram[i];
+    }
+    stats += "]}";
+
+    MLX90641_I2CStats i2c;
+    MLX90641_I2CGetStats(&i2c);
+    uint32_t frames = MLX90641Assembler.frames - statsFramesBase;
+    stats += ",\"i2c\":{\"transfer_bytes\":";
+    stats += MLX90641_I2CGetTransferSize();
+    stats += ",\"transactions\":";
+    stats += i2c.transactions;
+    stats += ",\"bytes\":";
+    stats += i2c.bytes;
+    stats += ",\"transactions_per_frame\":";
+    stats += frames ? i2c.transactions / frames : 0;
+    stats += ",\"bytes_per_frame\":";
+    stats += frames ? i2c.bytes / frames : 0;
+    stats += "},\"boot\":{\"calibration\":\"";
+    stats += calibrationCached ? "cache" : "eeprom";
+    stats += "\",\"calibration_ms\":";
+    stats += calibrationMillis;
+    stats += ",\"first_frame_ms\":";
+    stats += firstFrameMillis;
+    stats += "}}";
+    server.send(200, "application/json", stats.c_str());
+    recordRequest();
+
+    if (server.hasArg("reset"))
+    {
+        latencyReset(requestLatency);
+        latencyReset(loopLatency);
+        latencyReset(rawStreamLatency);
+        latencyReset(rawFirstChunkLatency);
+        latencyReset(trackerLatency);
+        latencyReset(filterLatency);
+        MLX90641_I2CResetStats();
+        statsFramesBase = MLX90641Assembler.frames;
+    }
+}
+
 void restart()
 {
     Serial.println("restarting ESP");
@@ -332,6 +733,7 @@ void notFound()
 {
     Serial.println("notFound");
     server.send(404, "text/plain", "Not found");
+    recordRequest();
 }
 
 // Returns true if the MLX90641 is detected on the I2C bus
@@ -346,12 +748,63 @@ boolean isConnected()
     return (true);
 }
 
+// Fills MLX90641 with the calibration parameters; returns false on failure
+bool loadCalibration()
+{
+    uint16_t id[3];
+    bool cacheUsable;
+    int status;
+
+    cacheUsable = MLX90641_ReadDeviceId(MLX90641_address, id) == 0 && LittleFS.begin();
+    if (cacheUsable &&
+        MLX90641_CacheLoad(MLX90641_FileStorage(), calibrationCachePath, id, &MLX90641) == 0)
+    {
+        calibrationCached = true;
+        calibrationMillis = millis();
+        Serial.println("Calibration loaded from cache");
+        return true;
+    }
+
+    // only needed until the parameters are extracted
+    uint16_t *eeData = (uint16_t *)malloc(832 * sizeof(uint16_t));
+    if (eeData == NULL)
+    {
+        return false;
+    }
+    status = MLX90641_DumpEE(MLX90641_address, eeData);
+    Serial.print("errorno: ");
+    Serial.println(status);
+    if (status == 0)
+    {
+        status = MLX90641_ExtractParameters(eeData, &MLX90641);
+        if (status != 0)
+        {
+            Serial.println("Parameter extraction failed");
+        }
+    }
+    free(eeData);
+    if (status != 0)
+    {
+        return false;
+    }
+    calibrationMillis = millis();
+
+    if (cacheUsable &&
+        MLX90641_CacheSave(MLX90641_FileStorage(), calibrationCachePath, id, &MLX90641) == 0)
+    {
+        Serial.println("Calibration cached");
+    }
+    return true;
+}
+
 void setup()
 {
     Serial.begin(9600);
 
     Wire.begin();
     Wire.setClock(400000); // Increase I2C clock speed to 400kHz
+    Serial.print("I2C transfer size: ");
+    Serial.println(MLX90641_I2CSetTransferSize(MLX90641_I2C_TRANSFER_BYTES));
 
     if (isConnected() == false)
     {
@@ -360,27 +813,22 @@ void setup()
             ;
     }
 
-    // Get device parameters - We only have to do this once
-    int status;
-    status = MLX90641_DumpEE(MLX90641_address, eeMLX90641);
-    int errorno = status; // MLX90641_CheckEEPROMValid(eeMLX90641); //eeMLX90641[10] & 0x0040; //
-    Serial.print("errorno: ");
-    Serial.println(errorno);
-
-    if (status != 0)
+    // Get device parameters - from the flash cache when it was written for this
+    // sensor, otherwise from the EEPROM (and cache them for the next boot)
+    if (!loadCalibration())
     {
         Serial.println("Failed to load system parameters");
         while (1)
             ;
     }
-
-    status = MLX90641_ExtractParameters(eeMLX90641, &MLX90641);
-    if (status != 0)
-    {
-        Serial.println("Parameter extraction failed");
-        while (1)
-            ;
-    }
+#ifndef MLX90641_FIXED_POINT
+    MLX90641_CompileParameters(&MLX90641, &MLX90641Calib);
+#endif
+    MLX90641_FrameStatsInit(&MLX90641Stats, 1000, 200); // 10 C to 42 C in 2 K bins
+    MLX90641_FrameInit(&MLX90641Assembler, onCameraFrame, NULL);
+    temporalFilterInit(temporalFilter, total_pixels, temporalFilterDefaults());
+    backgroundInit(background, backgroundDefaults());
+    trackerInit(tracker, trackerDefaults());
 
     // MLX90641_SetRefreshRate(MLX90641_address, 0x02); //Set rate to 2Hz
     MLX90641_SetRefreshRate(MLX90641_address, 0x03); // Set rate to 4Hz
@@ -420,7 +868,10 @@ void setup()
         }
 
         server.on("/raw", sendRaw);
+        server.on("/frame.bin", sendFrameBin);
         server.on("/restart", restart);
+        server.on("/bench", sendBench);
+        server.on("/stats", sendStats);
         server.on("/update", updateProperties);
         server.onNotFound(notFound);
 
@@ -448,25 +899,27 @@ void loop()
 {
     if (WiFi.status() == WL_CONNECTED)
     {
-        delay(100);
+        latencyRecord(loopLatency, micros() - lastClientPoll);
         server.handleClient();
+        lastClientPoll = micros();
     }
     if (getUptimeHours() > 1)
     {
         restart();
     }
-    if (mainLoopCounter > delayOutputComputation)
+
+    // detection runs on its own loop pass so a request is never kept waiting for both
+    if (outputPending)
     {
-        mainLoopCounter = 0;
-        Serial.println("frame reconstruction started");
-        refreshCameraTempsFrame();
+        outputPending = false;
         Serial.println("frame reconstruction finished -> building output started");
-        getRaw(humanThreshold, tempKoef);
+        getRaw(humanThreshold);
         Serial.println("building output finished");
     }
+    else
+    {
+        pollCamera();
+    }
 
     drd->loop();
-    mainLoopCounter++;
-    // Serial.print("Loop counter: ");
-    // Serial.println(mainLoopCounter);
 }
@@ -0,0 +1,328 @@
+#include "temporal_filter.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const filterNames[] = {"off", "average", "ewma", "kalman"};
+
+TemporalFilterConfig temporalFilterDefaults()
+{
+    TemporalFilterConfig config;
+
+    config.kind = TEMPORAL_FILTER_OFF;
+    config.window = 4;
+    config.alpha = 0.3f;
+    config.processNoise = 0.01f;     // 0.1 K per frame
+    config.measurementNoise = 0.04f; // 0.2 K, about the pixel noise at 4 Hz
+    config.gate = 4.0f;
+    return config;
+}
+
+const char *temporalFilterName(uint8_t kind)
+{
+    return kind <= TEMPORAL_FILTER_KALMAN ? filterNames[kind] : "unknown";
+}
+
+int temporalFilterParse(const char *name)
+{
+    for (int kind = TEMPORAL_FILTER_OFF; kind <= TEMPORAL_FILTER_KALMAN; kind++)
+    {
+        if (strcmp(name, filterNames[kind]) == 0)
+        {
+            return kind;
+        }
+    }
+    return -1;
+}
+
+static int16_t toCenti(float value)
+{
+    value *= 100.0f;
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)(value < 0 ? value - 0.5f : value + 0.5f);
+}
+
+static void addRange(TemporalFilterRange &range, int index, float value)
+{
+    if (value != value)
+    {
+        return;
+    }
+    if (range.count == 0 || value < range.min)
+    {
+        range.min = value;
+        range.argMin = index;
+    }
+    if (range.count == 0 || value > range.max)
+    {
+        range.max = value;
+        range.argMax = index;
+    }
+    range.sum += value;
+    range.count++;
+}
+
+//------------------------------------------------------------------------------
+
+// A NaN pixel writes its current mean into the ring, so the sum stays consistent.
+// A pixel without a reading yet outputs NaN and fills the ring with its first
+// number, the same per pixel start as ewma and kalman.
+static void applyAverage(TemporalFilterState &state, int16_t *history, int32_t *sum, float *output,
+                         const float *frame, int pixels, bool first, TemporalFilterRange &range)
+{
+    uint8_t window = state.config.window;
+    uint8_t filled = first ? 0 : state.filled;
+    uint8_t count = filled < window ? filled + 1 : window;
+    int16_t *slot = history + state.head * pixels;
+    const float scale = 1.0f / (100.0f * count);
+
+    for (int i = 0; i < pixels; i++)
+    {
+        float value = frame[i];
+        bool started = filled != 0 && output[i] == output[i];
+
+        if (value != value && !started)
+        {
+            slot[i] = 0;
+            sum[i] = 0;
+            output[i] = NAN;
+            continue;
+        }
+
+        int16_t centi = value == value ? toCenti(value) : sum[i] / filled;
+        if (!started)
+        {
+            // the ring was filled from slot 0 on, so it holds slots 0 to count - 1
+            for (int k = 0; k < count; k++)
+            {
+                history[k * pixels + i] = centi;
+            }
+            sum[i] = (int32_t)centi * count;
+        }
+        else
+        {
+            if (filled == window)
+            {
+                sum[i] -= slot[i];
+            }
+            slot[i] = centi;
+            sum[i] += centi;
+        }
+
+        output[i] = sum[i] * scale;
+        addRange(range, i, output[i]);
+    }
+
+    state.head = state.head + 1 < window ? state.head + 1 : 0;
+    state.filled = count;
+}
+
+static void applyEwma(const TemporalFilterConfig &config, float *output, const float *frame, int pixels, bool first,
+                      TemporalFilterRange &range)
+{
+    for (int i = 0; i < pixels; i++)
+    {
+        float value = frame[i];
+
+        if (first || output[i] != output[i])
+        {
+            output[i] = value;
+        }
+        else if (value == value)
+        {
+            output[i] += config.alpha * (value - output[i]);
+        }
+        addRange(range, i, output[i]);
+    }
+}
+
+static void applyKalman(const TemporalFilterConfig &config, float *output, float *variance, const float *frame,
+                        int pixels, bool first, TemporalFilterRange &range)
+{
+    const float gate2 = config.gate * config.gate;
+
+    for (int i = 0; i < pixels; i++)
+    {
+        float value = frame[i];
+
+        if (first || output[i] != output[i])
+        {
+            output[i] = value;
+            variance[i] = config.measurementNoise;
+        }
+        else if (value == value)
+        {
+            float predicted = variance[i] + config.processNoise;
+            float innovation = value - output[i];
+
+            if (gate2 > 0 && innovation * innovation > gate2 * (predicted + config.measurementNoise))
+            {
+                output[i] = value;
+                variance[i] = config.measurementNoise;
+            }
+            else
+            {
+                float gain = predicted / (predicted + config.measurementNoise);
+                output[i] += gain * innovation;
+                variance[i] = (1.0f - gain) * predicted;
+            }
+        }
+        addRange(range, i, output[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+const float *temporalFilterApply(TemporalFilterState &state, int16_t *history, int32_t *sum, float *output,
+                                 float *variance, const float *frame, int pixels, TemporalFilterRange &range)
+{
+    TemporalFilterConfig &config = state.config;
+
+    if (config.kind == TEMPORAL_FILTER_OFF || config.kind > TEMPORAL_FILTER_KALMAN)
+    {
+        state.filled = 0;
+        return frame;
+    }
+
+    if (config.window < 1)
+    {
+        config.window = 1;
+    }
+    else if (config.window > TEMPORAL_FILTER_MAX_WINDOW)
+    {
+        config.window = TEMPORAL_FILTER_MAX_WINDOW;
+    }
+    // a window changed without a restart leaves the ring inconsistent
+    bool first = state.filled == 0 || state.filled > config.window || state.head >= config.window;
+    if (first)
+    {
+        state.head = 0;
+    }
+
+    range.count = 0;
+    range.sum = 0;
+    switch (config.kind)
+    {
+    case TEMPORAL_FILTER_AVERAGE:
+        applyAverage(state, history, sum, output, frame, pixels, first, range);
+        break;
+    case TEMPORAL_FILTER_EWMA:
+        applyEwma(config, output, frame, pixels, first, range);
+        state.filled = 1;
+        break;
+    default:
+        applyKalman(config, output, variance, frame, pixels, first, range);
+        state.filled = 1;
+        break;
+    }
+
+    return output;
+}
+
+//------------------------------------------------------------------------------
+
+static uint8_t clampWindow(uint8_t window)
+{
+    return window < 1 ? 1 : window > TEMPORAL_FILTER_MAX_WINDOW ? TEMPORAL_FILTER_MAX_WINDOW : window;
+}
+
+static size_t layoutBytes(uint8_t kind, uint8_t window, int pixels)
+{
+    switch (kind)
+    {
+    case TEMPORAL_FILTER_AVERAGE:
+        return (size_t)pixels * (sizeof(float) + sizeof(int32_t) + window * sizeof(int16_t));
+    case TEMPORAL_FILTER_EWMA:
+        return (size_t)pixels * sizeof(float);
+    case TEMPORAL_FILTER_KALMAN:
+        return (size_t)pixels * 2 * sizeof(float);
+    default:
+        return 0;
+    }
+}
+
+static void release(TemporalFilter &filter)
+{
+    free(filter.block);
+    filter.block = NULL;
+    filter.history = NULL;
+    filter.sum = NULL;
+    filter.output = NULL;
+    filter.variance = NULL;
+    filter.kind = TEMPORAL_FILTER_OFF;
+    filter.window = 0;
+}
+
+// Lays out the block for the configured kind: the 4 byte lanes first, the
+// int16 history last. Returns false if it cannot be allocated.
+static bool allocate(TemporalFilter &filter)
+{
+    uint8_t kind = filter.state.config.kind;
+    uint8_t window = clampWindow(filter.state.config.window);
+
+    if (kind == filter.kind && (kind != TEMPORAL_FILTER_AVERAGE || window == filter.window) && filter.block != NULL)
+    {
+        return true;
+    }
+
+    release(filter);
+    filter.state.filled = 0;
+    filter.block = malloc(layoutBytes(kind, window, filter.pixels));
+    if (filter.block == NULL)
+    {
+        return false;
+    }
+
+    float *lane = (float *)filter.block;
+    filter.output = lane;
+    if (kind == TEMPORAL_FILTER_KALMAN)
+    {
+        filter.variance = lane + filter.pixels;
+    }
+    if (kind == TEMPORAL_FILTER_AVERAGE)
+    {
+        filter.sum = (int32_t *)(lane + filter.pixels);
+        filter.history = (int16_t *)(filter.sum + filter.pixels);
+    }
+    filter.kind = kind;
+    filter.window = window;
+    return true;
+}
+
+void temporalFilterInit(TemporalFilter &filter, int pixels, const TemporalFilterConfig &config)
+{
+    release(filter);
+    filter.pixels = pixels;
+    filter.state.config = config;
+    filter.state.filled = 0;
+    filter.state.head = 0;
+}
+
+const float *temporalFilterApply(TemporalFilter &filter, const float *frame, int pixels, TemporalFilterRange &range)
+{
+    uint8_t kind = filter.state.config.kind;
+
+    if (kind == TEMPORAL_FILTER_OFF || kind > TEMPORAL_FILTER_KALMAN)
+    {
+        release(filter);
+    }
+    else if (pixels > filter.pixels || !allocate(filter))
+    {
+        filter.state.filled = 0;
+        return frame;
+    }
+    return temporalFilterApply(filter.state, filter.history, filter.sum, filter.output, filter.variance, frame, pixels,
+                               range);
+}
+
+size_t temporalFilterBytes(const TemporalFilter &filter)
+{
+    return filter.block != NULL ? layoutBytes(filter.kind, filter.window, filter.pixels) : 0;
+}
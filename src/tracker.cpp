@@ -0,0 +1,206 @@
+#include "tracker.h"
+#include <string.h>
+
+TrackerConfig trackerDefaults()
+{
+    TrackerConfig config;
+
+    config.maxDistance = 3.0f;
+    config.confirmFrames = 2;
+    config.dropFrames = 3;
+    config.lineRow = -1.0f;
+    config.lineMargin = 0.5f;
+    return config;
+}
+
+void trackerInit(Tracker &tracker, const TrackerConfig &config)
+{
+    memset(&tracker, 0, sizeof(tracker));
+    tracker.config = config;
+    tracker.nextId = 1;
+}
+
+static int8_t lineSide(const TrackerConfig &config, float row)
+{
+    if (config.lineRow < 0)
+    {
+        return 0;
+    }
+    if (row > config.lineRow + config.lineMargin)
+    {
+        return 1;
+    }
+    if (row < config.lineRow - config.lineMargin)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// Tentative tracks keep the side they were born on, so a crossing during
+// confirmation is still counted once they are confirmed
+static void updateSide(Tracker &tracker, Track &track)
+{
+    int8_t side = lineSide(tracker.config, track.row);
+
+    if (!track.confirmed || side == 0)
+    {
+        return;
+    }
+    if (track.side != 0 && side != track.side)
+    {
+        if (side > 0)
+        {
+            tracker.lineIn++;
+        }
+        else
+        {
+            tracker.lineOut++;
+        }
+    }
+    track.side = side;
+}
+
+static void startTrack(Tracker &tracker, const Blob &blob)
+{
+    for (int t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        Track &track = tracker.tracks[t];
+        if (track.id != 0)
+        {
+            continue;
+        }
+
+        track.id = tracker.nextId++;
+        if (tracker.nextId == 0)
+        {
+            tracker.nextId = 1;
+        }
+        track.row = blob.centroidRow;
+        track.col = blob.centroidCol;
+        track.velocityRow = 0;
+        track.velocityCol = 0;
+        track.hits = 1;
+        track.misses = 0;
+        track.confirmed = tracker.config.confirmFrames <= 1;
+        track.side = lineSide(tracker.config, track.row);
+        return;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void trackerUpdate(Tracker &tracker, const BlobList &people)
+{
+    const float maxDistance2 = tracker.config.maxDistance * tracker.config.maxDistance;
+    float distance2[TRACKER_MAX_TRACKS][BLOB_MAX_BLOBS];
+    bool trackMatched[TRACKER_MAX_TRACKS] = {};
+    bool blobMatched[BLOB_MAX_BLOBS] = {};
+
+    // squared distances from the predicted positions, pairs too far apart are never matched
+    for (int t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        const Track &track = tracker.tracks[t];
+        for (int b = 0; b < people.count; b++)
+        {
+            float dRow = people.blobs[b].centroidRow - (track.row + track.velocityRow);
+            float dCol = people.blobs[b].centroidCol - (track.col + track.velocityCol);
+            float d2 = dRow * dRow + dCol * dCol;
+            distance2[t][b] = track.id != 0 && d2 <= maxDistance2 ? d2 : -1.0f;
+        }
+    }
+
+    // greedy assignment, closest pair first; with at most 8 x 16 pairs this beats an optimal solver
+    for (;;)
+    {
+        int bestTrack = -1;
+        int bestBlob = -1;
+        float best = 0;
+
+        for (int t = 0; t < TRACKER_MAX_TRACKS; t++)
+        {
+            if (trackMatched[t])
+            {
+                continue;
+            }
+            for (int b = 0; b < people.count; b++)
+            {
+                float d2 = distance2[t][b];
+                if (!blobMatched[b] && d2 >= 0 && (bestTrack < 0 || d2 < best))
+                {
+                    bestTrack = t;
+                    bestBlob = b;
+                    best = d2;
+                }
+            }
+        }
+        if (bestTrack < 0)
+        {
+            break;
+        }
+
+        Track &track = tracker.tracks[bestTrack];
+        const Blob &blob = people.blobs[bestBlob];
+        trackMatched[bestTrack] = true;
+        blobMatched[bestBlob] = true;
+
+        track.velocityRow = 0.5f * (track.velocityRow + blob.centroidRow - track.row);
+        track.velocityCol = 0.5f * (track.velocityCol + blob.centroidCol - track.col);
+        track.row = blob.centroidRow;
+        track.col = blob.centroidCol;
+        track.misses = 0;
+        if (track.hits < UINT8_MAX)
+        {
+            track.hits++;
+        }
+        if (track.hits >= tracker.config.confirmFrames)
+        {
+            track.confirmed = true;
+        }
+        updateSide(tracker, track);
+    }
+
+    // missed tracks coast on their slowing velocity until they are dropped
+    for (int t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        Track &track = tracker.tracks[t];
+        if (track.id == 0 || trackMatched[t])
+        {
+            continue;
+        }
+
+        track.hits = 0;
+        track.misses++;
+        if (!track.confirmed || track.misses > tracker.config.dropFrames)
+        {
+            track.id = 0;
+            continue;
+        }
+        track.row += track.velocityRow;
+        track.col += track.velocityCol;
+        track.velocityRow *= 0.5f;
+        track.velocityCol *= 0.5f;
+    }
+
+    for (int b = 0; b < people.count; b++)
+    {
+        if (!blobMatched[b])
+        {
+            startTrack(tracker, people.blobs[b]);
+        }
+    }
+}
+
+int trackerCount(const Tracker &tracker)
+{
+    int count = 0;
+
+    for (int t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        if (tracker.tracks[t].id != 0 && tracker.tracks[t].confirmed)
+        {
+            count++;
+        }
+    }
+    return count;
+}
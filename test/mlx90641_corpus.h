@@ -0,0 +1,192 @@
+#ifndef MLX90641_CORPUS_H
+#define MLX90641_CORPUS_H
+
+#include <stdint.h>
+
+// Recorded inputs shared by the native tests and the host benchmark: a raw
+// (Hamming encoded) EEPROM dump of 832 words and four frameData records of 242
+// words as returned by MLX90641_GetFrameData, alternating sub-pages. They were
+// captured from the simulated sensor (MLX90641_I2C_Sim) with its synthetic
+// EEPROM, looking at a 21.5..23C wall with a 33C person walking across it,
+// at Ta 26..26.3C.
+
+#define CORPUS_FRAMES 4
+
+static const uint16_t corpusEeData[832] = {
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0040, 0x0000,
+    0x0901, 0x0000, 0x0000, 0x0000, 0x5840, 0x8FE0, 0xF018, 0x0000, 0x0000, 0x9050, 0xD1C0, 0x3864,
+    0x6900, 0x018C, 0x018C, 0x018C, 0x6DDC, 0x6DDC, 0x6DDC, 0x6DDC, 0x6DDC, 0x6DDC, 0x3FBE, 0x7200,
+    0xF0BB, 0xC810, 0x8667, 0xDF9D, 0x917F, 0x5011, 0x5152, 0xA009, 0x1C80, 0x04B0, 0xC826, 0x67FE,
+    0xB004, 0xD310, 0x0948, 0x2C20, 0x5011, 0x4F97, 0x4F97, 0x4F97, 0x4F97, 0x4F97, 0x80C8, 0x4F97,
+    0x9918, 0x4F97, 0x312C, 0x4F97, 0x07EC, 0x77F3, 0xD7FA, 0x9801, 0x3808, 0xB80F, 0x9FED, 0xF7F4,
+    0x4FFB, 0xA802, 0xA009, 0xC810, 0xAFEE, 0x6FF5, 0xCFFC, 0x3003, 0x900A, 0x5011, 0x37EF, 0x5FF6,
+    0x57FD, 0xB004, 0x080B, 0x6012, 0x47F0, 0xC7F7, 0x67FE, 0x2805, 0x880C, 0xF813, 0xDFF1, 0x7FF8,
+    0xFFFF, 0x1806, 0x100D, 0x7814, 0xEFF2, 0xE7F9, 0x0000, 0x8007, 0x200E, 0x07EC, 0x77F3, 0xD7FA,
+    0x9801, 0x3808, 0xB80F, 0x9FED, 0xF7F4, 0x4FFB, 0xA802, 0xA009, 0xC810, 0xAFEE, 0x6FF5, 0xCFFC,
+    0x3003, 0x900A, 0x5011, 0x37EF, 0x5FF6, 0x57FD, 0xB004, 0x080B, 0x6012, 0x47F0, 0xC7F7, 0x67FE,
+    0x2805, 0x880C, 0xF813, 0xDFF1, 0x7FF8, 0xFFFF, 0x1806, 0x100D, 0x7814, 0xEFF2, 0xE7F9, 0x0000,
+    0x8007, 0x200E, 0x07EC, 0x77F3, 0xD7FA, 0x9801, 0x3808, 0xB80F, 0x9FED, 0xF7F4, 0x4FFB, 0xA802,
+    0xA009, 0xC810, 0xAFEE, 0x6FF5, 0xCFFC, 0x3003, 0x900A, 0x5011, 0x37EF, 0x5FF6, 0x57FD, 0xB004,
+    0x080B, 0x6012, 0x47F0, 0xC7F7, 0x67FE, 0x2805, 0x880C, 0xF813, 0xDFF1, 0x7FF8, 0xFFFF, 0x1806,
+    0x100D, 0x7814, 0xEFF2, 0xE7F9, 0x0000, 0x8007, 0x200E, 0x07EC, 0x77F3, 0xD7FA, 0x9801, 0x3808,
+    0xB80F, 0x9FED, 0xF7F4, 0x4FFB, 0xA802, 0xA009, 0xC810, 0xAFEE, 0x6FF5, 0xCFFC, 0x3003, 0x900A,
+    0x5011, 0x37EF, 0x5FF6, 0x57FD, 0xB004, 0x080B, 0x6012, 0x47F0, 0xC7F7, 0x67FE, 0x2805, 0x880C,
+    0xF813, 0xDFF1, 0x7FF8, 0xFFFF, 0x1806, 0x100D, 0x7814, 0xEFF2, 0xE7F9, 0x0000, 0x8007, 0x200E,
+    0x07EC, 0x77F3, 0xD7FA, 0x9801, 0x3808, 0xB80F, 0x9FED, 0xF7F4, 0x4FFB, 0xA802, 0xA009, 0xC810,
+    0xAFEE, 0x6FF5, 0xCFFC, 0x3003, 0x900A, 0x5011, 0x37EF, 0x5FF6, 0x57FD, 0xB004, 0x080B, 0x6012,
+    0x47F0, 0xC7F7, 0x67FE, 0x2805, 0xD640, 0xC64D, 0x8E5A, 0x8667, 0x7E74, 0xF681, 0x4E8E, 0xAE9B,
+    0x86A8, 0x5EB5, 0x9EC2, 0x8ECF, 0x76DC, 0x46E9, 0x36F6, 0xD703, 0x2F10, 0x3F1D, 0xA72A, 0x7F37,
+    0x0F44, 0xEF51, 0x575E, 0x676B, 0x5E4C, 0xBE59, 0x1E66, 0xFE73, 0x6E80, 0x7E8D, 0x369A, 0x3EA7,
+    0xC6B4, 0xAEC1, 0x16CE, 0xF6DB, 0xDEE8, 0x06F5, 0x4F02, 0x5F0F, 0xA71C, 0x9729, 0xE736, 0x8F43,
+    0x7750, 0x675D, 0xFF6A, 0xDE4B, 0x2658, 0x2E65, 0x6672, 0x767F, 0xE68C, 0x0699, 0xA6A6, 0x46B3,
+    0x36C0, 0x26CD, 0x6EDA, 0x66E7, 0x9EF4, 0x7F01, 0xC70E, 0x271B, 0x0F28, 0xD735, 0x1742, 0x074F,
+    0xFF5C, 0xCF69, 0x464A, 0x9E57, 0xB664, 0x5671, 0xEE7E, 0x668B, 0x9E98, 0x96A5, 0xDEB2, 0xCEBF,
+    0xBECC, 0x5ED9, 0xFEE6, 0x1EF3, 0xE700, 0xF70D, 0xBF1A, 0xB727, 0x4F34, 0x2741, 0x9F4E, 0x7F5B,
+    0x5768, 0x7649, 0x0656, 0x3663, 0xCE70, 0xDE7D, 0xFE8A, 0x2697, 0x0EA4, 0xEEB1, 0x56BE, 0x3ECB,
+    0xC6D8, 0xCEE5, 0x86F2, 0x96FF, 0x6F0C, 0x8F19, 0x2F26, 0xCF33, 0xBF40, 0xAF4D, 0xE75A, 0xEF67,
+    0xEE48, 0x3655, 0xAE62, 0xBE6F, 0x467C, 0xCE89, 0xBE96, 0x8EA3, 0x76B0, 0x66BD, 0xA6CA, 0x7ED7,
+    0x56E4, 0xB6F1, 0x0EFE, 0xEF0B, 0x1718, 0x1F25, 0x5732, 0x473F, 0x374C, 0xD759, 0x7766, 0x5647,
+    0xAE54, 0x9E61, 0x266E, 0xC67B, 0x5688, 0x8E95, 0x16A2, 0x06AF, 0xFEBC, 0x96C9, 0xE6D6, 0xD6E3,
+    0x2EF0, 0x3EFD, 0x770A, 0xAF17, 0x8724, 0x6731, 0xDF3E, 0xB74B, 0x4F58, 0x4765, 0xCE46, 0x2E53,
+    0x0660, 0x166D, 0x5E7A, 0xEE87, 0x1694, 0x26A1, 0x9EAE, 0x7EBB, 0x0EC8, 0xD6D5, 0x4EE2, 0x5EEF,
+    0xA6FC, 0x4709, 0x3716, 0x0723, 0xFF30, 0xEF3D, 0x2F4A, 0xF757, 0xDF64, 0xFE45, 0xB652, 0xA65F,
+    0x8E6C, 0x6E79, 0x7686, 0x9693, 0xEF9E, 0xA7BF, 0x5FC0, 0x17E1, 0xA802, 0x383E, 0x285F, 0x8860,
+    0x7881, 0xAF82, 0x3FBE, 0x2FDF, 0x8FE0, 0x9801, 0x7822, 0xB05E, 0xF87F, 0xE080, 0x9F81, 0x7FA2,
+    0xB7DE, 0xFFFF, 0x0000, 0x4821, 0xF042, 0x607E, 0x909F, 0x0780, 0x4FA1, 0xF7C2, 0x67FE, 0x701F,
+    0xD020, 0xC041, 0x2062, 0x089E, 0x779F, 0xD7A0, 0xC7C1, 0x27E2, 0xE81E, 0xA03F, 0x5840, 0x1061,
+    0x4882, 0xEF9E, 0xA7BF, 0x5FC0, 0x17E1, 0xA802, 0x383E, 0x285F, 0x8860, 0x7881, 0xAF82, 0x3FBE,
+    0x2FDF, 0x8FE0, 0x9801, 0x7822, 0xB05E, 0xF87F, 0xE080, 0x9F81, 0x7FA2, 0xB7DE, 0xFFFF, 0x0000,
+    0x4821, 0xF042, 0x607E, 0x909F, 0x0780, 0x4FA1, 0xF7C2, 0x67FE, 0x701F, 0xD020, 0xC041, 0x2062,
+    0x089E, 0x779F, 0xD7A0, 0xC7C1, 0x27E2, 0xE81E, 0xA03F, 0x5840, 0x1061, 0x4882, 0xEF9E, 0xA7BF,
+    0x5FC0, 0x17E1, 0xA802, 0x383E, 0x285F, 0x8860, 0x7881, 0xAF82, 0x3FBE, 0x2FDF, 0x8FE0, 0x9801,
+    0x7822, 0xB05E, 0xF87F, 0xE080, 0x9F81, 0x7FA2, 0xB7DE, 0xFFFF, 0x0000, 0x4821, 0xF042, 0x607E,
+    0x909F, 0x0780, 0x4FA1, 0xF7C2, 0x67FE, 0x701F, 0xD020, 0xC041, 0x2062, 0x089E, 0x779F, 0xD7A0,
+    0xC7C1, 0x27E2, 0xE81E, 0xA03F, 0x5840, 0x1061, 0x4882, 0xEF9E, 0xA7BF, 0x5FC0, 0x17E1, 0xA802,
+    0x383E, 0x285F, 0x8860, 0x7881, 0xAF82, 0x3FBE, 0x2FDF, 0x8FE0, 0x9801, 0x7822, 0xB05E, 0xF87F,
+    0xE080, 0x9F81, 0x7FA2, 0xB7DE, 0xFFFF, 0x0000, 0x4821, 0xF042, 0x607E, 0x909F, 0x0780, 0x4FA1,
+    0xF7C2, 0x67FE, 0x701F, 0xD020, 0xC041, 0x2062, 0x089E, 0x779F, 0xD7A0, 0xC7C1, 0x27E2, 0xE81E,
+    0xA03F, 0x5840, 0x1061, 0x4882, 0xEF9E, 0xA7BF, 0x5FC0, 0x17E1, 0xA802, 0x383E, 0x285F, 0x8860,
+    0x7881, 0xAF82, 0x3FBE, 0x2FDF, 0xAFEE, 0xE7F9, 0xB004, 0xB80F, 0x6FF5, 0x0000, 0x080B, 0xDFF1,
+    0xCFFC, 0x8007, 0x6012, 0x7FF8, 0x3003, 0x200E, 0xF7F4, 0xFFFF, 0x900A, 0x47F0, 0x4FFB, 0x1806,
+    0x5011, 0xC7F7, 0xA802, 0x100D, 0x77F3, 0x67FE, 0xA009, 0x37EF, 0xD7FA, 0x2805, 0xC810, 0x5FF6,
+    0x9801, 0x880C, 0xEFF2, 0x57FD, 0x3808, 0xAFEE, 0xE7F9, 0xB004, 0xB80F, 0x6FF5, 0x0000, 0x080B,
+    0xDFF1, 0xCFFC, 0x8007, 0x6012, 0x7FF8, 0x3003, 0x200E, 0xF7F4, 0xFFFF, 0x900A, 0x47F0, 0x4FFB,
+    0x1806, 0x5011, 0xC7F7, 0xA802, 0x100D, 0x77F3, 0x67FE, 0xA009, 0x37EF, 0xD7FA, 0x2805, 0xC810,
+    0x5FF6, 0x9801, 0x880C, 0xEFF2, 0x57FD, 0x3808, 0xAFEE, 0xE7F9, 0xB004, 0xB80F, 0x6FF5, 0x0000,
+    0x080B, 0xDFF1, 0xCFFC, 0x8007, 0x6012, 0x7FF8, 0x3003, 0x200E, 0xF7F4, 0xFFFF, 0x900A, 0x47F0,
+    0x4FFB, 0x1806, 0x5011, 0xC7F7, 0xA802, 0x100D, 0x77F3, 0x67FE, 0xA009, 0x37EF, 0xD7FA, 0x2805,
+    0xC810, 0x5FF6, 0x9801, 0x880C, 0xEFF2, 0x57FD, 0x3808, 0xAFEE, 0xE7F9, 0xB004, 0xB80F, 0x6FF5,
+    0x0000, 0x080B, 0xDFF1, 0xCFFC, 0x8007, 0x6012, 0x7FF8, 0x3003, 0x200E, 0xF7F4, 0xFFFF, 0x900A,
+    0x47F0, 0x4FFB, 0x1806, 0x5011, 0xC7F7, 0xA802, 0x100D, 0x77F3, 0x67FE, 0xA009, 0x37EF, 0xD7FA,
+    0x2805, 0xC810, 0x5FF6, 0x9801, 0x880C, 0xEFF2, 0x57FD, 0x3808, 0xAFEE, 0xE7F9, 0xB004, 0xB80F,
+    0x6FF5, 0x0000, 0x080B, 0xDFF1, 0xCFFC, 0x8007, 0x6012, 0x7FF8, 0x3003, 0x200E, 0xF7F4, 0xFFFF,
+    0x900A, 0x47F0, 0x4FFB, 0x1806, 0x5011, 0xC7F7, 0xA802, 0x100D, 0x77F3, 0x67FE, 0xA009, 0x37EF,
+    0xD7FA, 0x2805, 0xC810, 0x5FF6, 0x9801, 0x880C, 0xEFF2, 0x57FD, 0x3808, 0xAFEE, 0xE7F9, 0xB004,
+    0xB80F, 0x6FF5, 0x0000, 0x080B,
+};
+
+static const uint16_t corpusFrames[CORPUS_FRAMES * 242] = {
+    // sub-page 0
+    0xFB44, 0xFB62, 0xFB80, 0xFB9E, 0xFBBC, 0xFBDA, 0xFB53, 0xFB71, 0xFB8F, 0xFBAE, 0xFBCC, 0xFBEB,
+    0xFB64, 0xFB83, 0xFBA1, 0xFBC0, 0xFBAC, 0xFBCA, 0xFB44, 0xFB62, 0xFB81, 0xFB9F, 0xFBBE, 0xFBDC,
+    0xFB69, 0xFB87, 0xFBA5, 0xFBC4, 0xFBE2, 0xFC01, 0xFB7A, 0xFB98, 0xFB87, 0xFBA5, 0xFBC3, 0xFBE1,
+    0xFB5B, 0xFB7A, 0xFB98, 0xFBB6, 0xFBD4, 0xFB4E, 0xFB6D, 0xFB8B, 0xFBAA, 0xFBC9, 0xFBE7, 0xFB71,
+    0xFB62, 0xFB80, 0xFB9E, 0xFBBC, 0xFBDA, 0xFB53, 0xFCC3, 0xFB90, 0xFBAE, 0xFBCD, 0xFBEB, 0xFB64,
+    0xFB83, 0xFBA1, 0xFBC0, 0xFBDF, 0xFBCB, 0xFB44, 0xFB62, 0xFB81, 0xFB9F, 0xFD39, 0xFD30, 0xFCA9,
+    0xFB88, 0xFBA6, 0xFBC5, 0xFBE3, 0xFC01, 0xFB7A, 0xFB99, 0xFBB7, 0xFBA5, 0xFBC4, 0xFB3D, 0xFB5B,
+    0xFCE3, 0xFD01, 0xFD1E, 0xFD3C, 0xFCB5, 0xFB6D, 0xFB8C, 0xFBAA, 0xFBC9, 0xFBF8, 0xFB72, 0xFB90,
+    0xFB80, 0xFB9E, 0xFBBC, 0xFBDB, 0xFB54, 0xFCC9, 0xFCE6, 0xFD04, 0xFBCD, 0xFBEB, 0xFB65, 0xFB83,
+    0xFBA2, 0xFBC1, 0xFBDF, 0xFBFE, 0xFB44, 0xFB62, 0xFB80, 0xFB9F, 0xFBD3, 0xFBF1, 0xFCAF, 0xFB89,
+    0xFBA7, 0xFBC5, 0xFBE3, 0xFB5C, 0xFB7B, 0xFB99, 0xFBB8, 0xFBD6, 0xFBC4, 0xFB3D, 0xFB5B, 0xFB7A,
+    0xFB98, 0xFBB6, 0xFBD4, 0xFB4F, 0xFB6D, 0xFB8C, 0xFBAA, 0xFBDB, 0xFBF9, 0xFB72, 0xFB90, 0xFBAF,
+    0xFB9F, 0xFBBD, 0xFBDB, 0xFB54, 0xFB72, 0xFB90, 0xFBAF, 0xFBCD, 0xFBEB, 0xFB65, 0xFB84, 0xFBA2,
+    0xFBC1, 0xFBDF, 0xFBFE, 0xFB78, 0xFB62, 0xFB80, 0xFBB6, 0xFBD4, 0xFB4D, 0xFB6B, 0xFB89, 0xFBA7,
+    0xFBC5, 0xFBE3, 0xFB5D, 0xFB7C, 0xFB9A, 0xFBB8, 0xFBD7, 0xFBF5, 0xFB3D, 0xFB5B, 0xFB79, 0xFB98,
+    0xFBB7, 0xFBD5, 0xFB4F, 0xFB6D, 0xFB8B, 0xFBBD, 0xFBDB, 0xFBF9, 0xFB73, 0xFB91, 0xFBB0, 0xFBCE,
+    0x47FD, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFFC4, 0x0000, 0x1770, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x05DC, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xCCE0, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0981, 0x0000,
+    // sub-page 1
+    0xFB49, 0xFB77, 0xFBA5, 0xFBD3, 0xFB6C, 0xFB9A, 0xFBC8, 0xFB62, 0xFB90, 0xFBBF, 0xFBED, 0xFB87,
+    0xFBB5, 0xFBE4, 0xFB7D, 0xFBAC, 0xFBA8, 0xFB42, 0xFB71, 0xFB9F, 0xFBCD, 0xFB67, 0xFB96, 0xFBC4,
+    0xFB72, 0xFBA0, 0xFBCE, 0xFB68, 0xFB97, 0xFBC5, 0xFBF3, 0xFB8D, 0xFB8C, 0xFBBA, 0xFB53, 0xFB81,
+    0xFBB0, 0xFB4A, 0xFB78, 0xFBA6, 0xFBD5, 0xFB6E, 0xFB9D, 0xFBCC, 0xFB65, 0xFB95, 0xFBC3, 0xFC03,
+    0xFB6F, 0xFB9D, 0xFBCB, 0xFB64, 0xFB92, 0xFBC0, 0xFB5A, 0xFCDA, 0xFBB7, 0xFBE5, 0xFB7F, 0xFBAD,
+    0xFBDC, 0xFB75, 0xFBA4, 0xFBD3, 0xFB3A, 0xFB68, 0xFB97, 0xFBC5, 0xFB5F, 0xFB8D, 0xFD10, 0xFCA9,
+    0xFCD8, 0xFBC7, 0xFB61, 0xFB8F, 0xFBBD, 0xFBEC, 0xFB85, 0xFBB4, 0xFBB2, 0xFB4C, 0xFB7A, 0xFBA8,
+    0xFBD6, 0xFCD9, 0xFD07, 0xFD34, 0xFCCD, 0xFCFB, 0xFBC4, 0xFB5E, 0xFB8D, 0xFBCD, 0xFBFB, 0xFB95,
+    0xFB95, 0xFBC3, 0xFB5C, 0xFB8B, 0xFBB9, 0xFB52, 0xFCD7, 0xFD05, 0xFD32, 0xFB77, 0xFBA5, 0xFBD4,
+    0xFB6E, 0xFB9D, 0xFBCB, 0xFB65, 0xFB60, 0xFB8F, 0xFBBD, 0xFB57, 0xFB9B, 0xFBCA, 0xFB63, 0xFCD5,
+    0xFBBF, 0xFBEE, 0xFB87, 0xFBB5, 0xFBE4, 0xFB7D, 0xFBAC, 0xFBDB, 0xFB44, 0xFB72, 0xFBA0, 0xFBCE,
+    0xFB68, 0xFB96, 0xFBC5, 0xFB5F, 0xFB8D, 0xFBBC, 0xFB56, 0xFB97, 0xFBC5, 0xFBF3, 0xFB8D, 0xFBBB,
+    0xFBBC, 0xFB55, 0xFB83, 0xFBB1, 0xFB4B, 0xFB79, 0xFBA7, 0xFBD5, 0xFB6F, 0xFB9E, 0xFBCC, 0xFB66,
+    0xFB95, 0xFBC3, 0xFBF2, 0xFB8C, 0xFB86, 0xFBB5, 0xFB66, 0xFB94, 0xFBC2, 0xFB5B, 0xFB89, 0xFBB8,
+    0xFBE6, 0xFB7F, 0xFBAE, 0xFBDC, 0xFB76, 0xFBA5, 0xFBD3, 0xFB6D, 0xFB6A, 0xFB98, 0xFBC6, 0xFB60,
+    0xFB8F, 0xFBBD, 0xFB57, 0xFB85, 0xFBB4, 0xFB61, 0xFB8F, 0xFBBE, 0xFBEC, 0xFB86, 0xFBB4, 0xFBE3,
+    0x47F2, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFFC4, 0x0000, 0x1770, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x05DC, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xCCE0, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0981, 0x0001,
+    // sub-page 0
+    0xFB3D, 0xFB5B, 0xFB79, 0xFB97, 0xFBB5, 0xFBD3, 0xFB4C, 0xFB6A, 0xFB88, 0xFBA7, 0xFBC5, 0xFBE4,
+    0xFB5D, 0xFB7B, 0xFB9A, 0xFBB8, 0xFBA4, 0xFBC3, 0xFB3D, 0xFB5B, 0xFB79, 0xFB97, 0xFBB6, 0xFBD4,
+    0xFB62, 0xFB80, 0xFB9F, 0xFBBD, 0xFBDC, 0xFBFA, 0xFB73, 0xFB91, 0xFB80, 0xFB9E, 0xFBBC, 0xFBDA,
+    0xFB54, 0xFB72, 0xFB90, 0xFBAF, 0xFBCD, 0xFB46, 0xFB65, 0xFB83, 0xFBA2, 0xFBC1, 0xFBE0, 0xFB6A,
+    0xFB5B, 0xFB79, 0xFB97, 0xFBB5, 0xFBD3, 0xFB4C, 0xFB6B, 0xFB89, 0xFBA7, 0xFBC5, 0xFBE4, 0xFB5D,
+    0xFB7B, 0xFB9A, 0xFBB8, 0xFBD8, 0xFBC3, 0xFB3C, 0xFB5B, 0xFB79, 0xFB97, 0xFBB6, 0xFBEA, 0xFB63,
+    0xFCC0, 0xFBA0, 0xFBBE, 0xFBDC, 0xFBFA, 0xFB73, 0xFB92, 0xFBB0, 0xFB9E, 0xFBBD, 0xFB36, 0xFB54,
+    0xFB72, 0xFB90, 0xFBAF, 0xFD35, 0xFCAD, 0xFCCB, 0xFB84, 0xFBA2, 0xFBC1, 0xFBF2, 0xFB6B, 0xFB89,
+    0xFB79, 0xFB97, 0xFBB5, 0xFBD4, 0xFB4D, 0xFB6B, 0xFCDF, 0xFCFD, 0xFD1B, 0xFD38, 0xFCB1, 0xFB7C,
+    0xFB9B, 0xFBB9, 0xFBD8, 0xFBF6, 0xFB3C, 0xFB5A, 0xFB79, 0xFB97, 0xFBCC, 0xFBEB, 0xFB64, 0xFCC5,
+    0xFCE3, 0xFD01, 0xFBDC, 0xFB55, 0xFB74, 0xFB92, 0xFBB1, 0xFBCF, 0xFBBD, 0xFB36, 0xFB54, 0xFB72,
+    0xFB90, 0xFBAF, 0xFBCD, 0xFB47, 0xFCD1, 0xFB84, 0xFBA2, 0xFBD4, 0xFBF2, 0xFB6B, 0xFB89, 0xFBA8,
+    0xFB98, 0xFBB6, 0xFBD4, 0xFB4D, 0xFB6B, 0xFB89, 0xFBA7, 0xFBC6, 0xFBE4, 0xFB5E, 0xFB7C, 0xFB9B,
+    0xFBB9, 0xFBD8, 0xFBF6, 0xFB70, 0xFB5A, 0xFB78, 0xFBAF, 0xFBCD, 0xFB46, 0xFB64, 0xFB82, 0xFBA0,
+    0xFBBE, 0xFBDC, 0xFB55, 0xFB74, 0xFB93, 0xFBB1, 0xFBCF, 0xFBEE, 0xFB36, 0xFB54, 0xFB72, 0xFB90,
+    0xFBAF, 0xFBCD, 0xFB47, 0xFB65, 0xFB84, 0xFBB6, 0xFBD4, 0xFBF2, 0xFB6C, 0xFB8A, 0xFBA9, 0xFBC7,
+    0x47E7, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFFC4, 0x0000, 0x1770, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x05DC, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xCCE0, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0981, 0x0000,
+    // sub-page 1
+    0xFB42, 0xFB70, 0xFB9E, 0xFBCC, 0xFB65, 0xFB93, 0xFBC1, 0xFB5A, 0xFB89, 0xFBB8, 0xFBE6, 0xFB7F,
+    0xFBAE, 0xFBDC, 0xFB76, 0xFBA4, 0xFBA1, 0xFB3A, 0xFB69, 0xFB97, 0xFBC6, 0xFB5F, 0xFB8E, 0xFBBC,
+    0xFB6B, 0xFB99, 0xFBC7, 0xFB61, 0xFB90, 0xFBBE, 0xFBEC, 0xFB86, 0xFB84, 0xFBB3, 0xFB4C, 0xFB7A,
+    0xFBA9, 0xFB42, 0xFB71, 0xFB9F, 0xFBCD, 0xFB67, 0xFB95, 0xFBC4, 0xFB5E, 0xFB8D, 0xFBBC, 0xFBFC,
+    0xFB68, 0xFB96, 0xFBC4, 0xFB5D, 0xFB8B, 0xFBB9, 0xFB53, 0xFB81, 0xFBB0, 0xFBDE, 0xFB77, 0xFBA6,
+    0xFBD4, 0xFB6E, 0xFB9C, 0xFBCC, 0xFB33, 0xFB61, 0xFB8F, 0xFBBE, 0xFB57, 0xFB86, 0xFBCA, 0xFB63,
+    0xFB92, 0xFCFF, 0xFB5A, 0xFB88, 0xFBB6, 0xFBE4, 0xFB7E, 0xFBAC, 0xFBAA, 0xFB44, 0xFB73, 0xFBA1,
+    0xFBCF, 0xFB68, 0xFB97, 0xFBC5, 0xFCC6, 0xFCF3, 0xFD22, 0xFB56, 0xFB85, 0xFBC6, 0xFBF4, 0xFB8E,
+    0xFB8E, 0xFBBC, 0xFB55, 0xFB84, 0xFBB2, 0xFB4B, 0xFB7A, 0xFCFD, 0xFD2B, 0xFCC4, 0xFCF2, 0xFD20,
+    0xFB67, 0xFB95, 0xFBC4, 0xFB5D, 0xFB59, 0xFB87, 0xFBB5, 0xFB4F, 0xFB94, 0xFBC3, 0xFB5C, 0xFB8A,
+    0xFCFC, 0xFD2A, 0xFCC2, 0xFBAE, 0xFBDD, 0xFB76, 0xFBA5, 0xFBD4, 0xFB3C, 0xFB6A, 0xFB99, 0xFBC7,
+    0xFB60, 0xFB8F, 0xFBBD, 0xFB57, 0xFB86, 0xFD1F, 0xFB4E, 0xFB90, 0xFBBE, 0xFBED, 0xFB86, 0xFBB4,
+    0xFBB5, 0xFB4E, 0xFB7C, 0xFBAA, 0xFB43, 0xFB71, 0xFBA0, 0xFBCE, 0xFB67, 0xFB97, 0xFBC5, 0xFB5F,
+    0xFB8D, 0xFBBC, 0xFBEA, 0xFB84, 0xFB7F, 0xFBAD, 0xFB5F, 0xFB8D, 0xFBBB, 0xFB54, 0xFB82, 0xFBB1,
+    0xFBDF, 0xFB78, 0xFBA6, 0xFBD5, 0xFB6F, 0xFB9D, 0xFBCC, 0xFB65, 0xFB62, 0xFB90, 0xFBBF, 0xFB58,
+    0xFB87, 0xFBB6, 0xFB4F, 0xFB7E, 0xFBAC, 0xFB5A, 0xFB88, 0xFBB7, 0xFBE5, 0xFB7F, 0xFBAD, 0xFBDC,
+    0x47DC, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFFC4, 0x0000, 0x1770, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x05DC, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xCCE0, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0981, 0x0001,
+};
+
+// the scene the frames were synthesised from, pixel n at row n / 16, column n % 16
+static inline float corpusScene(int frame, int pixel)
+{
+    int dRow = pixel / 16 - 5 - frame / 2;
+    int dCol = pixel % 16 - 6 - frame;
+
+    if (dRow * dRow + dCol * dCol <= 4)
+    {
+        return 33.0f;
+    }
+    return 21.5f + 0.1f * (pixel % 16);
+}
+
+#endif
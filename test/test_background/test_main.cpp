@@ -0,0 +1,212 @@
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include "background.h"
+
+// A simulated 16 x 12 room: a radiator hot from boot, a wall slowly warming in
+// the sun and a person walking through. The radiator and the wall must be
+// learned as background while the person stays foreground.
+
+#define ROWS 16
+#define COLS 12
+
+static BackgroundModel<ROWS, COLS> model;
+static float frame[ROWS * COLS];
+static FrameMask foreground;
+static uint32_t seed;
+
+static uint32_t nextRandom()
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static float randomUnit()
+{
+    return (nextRandom() & 0xFFFF) / 65536.0f;
+}
+
+// roughly normal sensor noise of 0.15 K standard deviation
+static float noise()
+{
+    float sum = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        sum += randomUnit();
+    }
+    return (sum - 2.0f) * 0.26f;
+}
+
+static bool personAt(int k, int r, int c)
+{
+    int left = 4 + (k - 100) / 50;
+    return k >= 100 && k < 300 && r >= 6 && r < 9 && c >= left && c < left + 2;
+}
+
+static void room(int k)
+{
+    for (int r = 0; r < ROWS; r++)
+    {
+        for (int c = 0; c < COLS; c++)
+        {
+            float value = 22 + noise();
+            if (r < 3 && c < 3)
+            {
+                value = 35 + noise(); // radiator
+            }
+            if (c >= 10)
+            {
+                value += 3.0f * fminf(1.0f, k / 200.0f); // sunlit wall
+            }
+            if (personAt(k, r, c))
+            {
+                value = 30 + noise();
+            }
+            frame[r * COLS + c] = value;
+        }
+    }
+}
+
+static void fillFrame(float value)
+{
+    for (int i = 0; i < ROWS * COLS; i++)
+    {
+        frame[i] = value;
+    }
+}
+
+void setUp()
+{
+    seed = 3;
+    backgroundInit(model, backgroundDefaults());
+}
+
+void tearDown()
+{
+}
+
+void test_radiator_and_wall()
+{
+    int personPixels = 0;
+    int hits = 0;
+    int falseAlarms = 0;
+
+    for (int k = 0; k < 400; k++)
+    {
+        room(k);
+        backgroundUpdate(model, frame, ROWS, COLS, foreground);
+        if (k < 20)
+        {
+            continue; // settling
+        }
+        for (int r = 0; r < ROWS; r++)
+        {
+            for (int c = 0; c < COLS; c++)
+            {
+                bool person = personAt(k, r, c);
+                personPixels += person;
+                hits += person && maskTest(foreground, r, c);
+                falseAlarms += !person && maskTest(foreground, r, c);
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(1200, personPixels);
+    TEST_ASSERT_GREATER_THAN(personPixels * 95 / 100, hits);
+    // at most the odd noise pixel, out of 380 frames of 192 pixels
+    TEST_ASSERT_LESS_THAN(10, falseAlarms);
+}
+
+// a pixel without a reading at start is seeded with its first number, not
+// compared against a mean it never had
+void test_nan_at_start()
+{
+    const int pixel = 5 * COLS + 7;
+
+    for (int k = 0; k < 30; k++)
+    {
+        fillFrame(22);
+        if (k < 10)
+        {
+            frame[pixel] = NAN;
+        }
+        backgroundUpdate(model, frame, ROWS, COLS, foreground);
+        TEST_ASSERT_FALSE(maskAny(foreground));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 22.0f, model.mean[pixel]);
+
+    fillFrame(22);
+    frame[pixel] = 30;
+    backgroundUpdate(model, frame, ROWS, COLS, foreground);
+    TEST_ASSERT_EQUAL_INT(1, maskCount(foreground));
+    TEST_ASSERT_TRUE(maskTest(foreground, 5, 7));
+}
+
+// NaN readings later on neither flag nor disturb the learned pixel
+void test_nan_later()
+{
+    const int pixel = 2 * COLS + 3;
+
+    for (int k = 0; k < 30; k++)
+    {
+        fillFrame(22);
+        if (k % 3 == 2)
+        {
+            frame[pixel] = NAN;
+        }
+        backgroundUpdate(model, frame, ROWS, COLS, foreground);
+        TEST_ASSERT_FALSE(maskAny(foreground));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 22.0f, model.mean[pixel]);
+    TEST_ASSERT_TRUE(model.variance[pixel] > 0);
+}
+
+// somebody standing still for a minute at 4 Hz is not learned away
+void test_still_person()
+{
+    for (int k = 0; k < 50; k++)
+    {
+        room(0);
+        backgroundUpdate(model, frame, ROWS, COLS, foreground);
+    }
+    for (int k = 0; k < 240; k++)
+    {
+        room(0);
+        frame[8 * COLS + 6] = 30 + noise();
+        backgroundUpdate(model, frame, ROWS, COLS, foreground);
+        TEST_ASSERT_TRUE(maskTest(foreground, 8, 6));
+    }
+}
+
+// a reset forgets the scene: the next frame is seeded, nothing is foreground
+void test_reset()
+{
+    for (int k = 0; k < 50; k++)
+    {
+        fillFrame(22);
+        backgroundUpdate(model, frame, ROWS, COLS, foreground);
+    }
+    fillFrame(30);
+    backgroundUpdate(model, frame, ROWS, COLS, foreground);
+    TEST_ASSERT_EQUAL_INT(ROWS * COLS, maskCount(foreground));
+
+    backgroundReset(model);
+    TEST_ASSERT_EQUAL_UINT32(0, model.state.frames);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, model.variance[0]);
+    backgroundUpdate(model, frame, ROWS, COLS, foreground);
+    TEST_ASSERT_FALSE(maskAny(foreground));
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, model.mean[0]);
+    TEST_ASSERT_EQUAL_FLOAT(BACKGROUND_INITIAL_VARIANCE, model.variance[0]);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_radiator_and_wall);
+    RUN_TEST(test_nan_at_start);
+    RUN_TEST(test_nan_later);
+    RUN_TEST(test_still_person);
+    RUN_TEST(test_reset);
+    return UNITY_END();
+}
@@ -0,0 +1,111 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MLX90641_API.h"
+#include "MLX90641_Bench.h"
+#include "../mlx90641_corpus.h"
+
+// Host run of the /bench endpoint over the checked-in corpus, so kernel changes
+// can be compared without a board: pio test -e native -f test_bench -v
+
+#define REPORT_SIZE 4096
+
+int HammingDecode(uint16_t *eeData);
+
+static char report[REPORT_SIZE];
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// every validated kernel stays within its bound of MLX90641_CalculateTo
+static void assertErrors(const char *json)
+{
+    const char *key = "\"max_abs_error\":";
+    int validated = 0;
+
+    for (const char *at = strstr(json, key); at != NULL; at = strstr(at + 1, key))
+    {
+        TEST_ASSERT_TRUE(atof(at + strlen(key)) < 0.05);
+        validated++;
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(4, validated);
+}
+
+void test_bench_corpus()
+{
+    MLX90641_BenchCorpus corpus = {corpusEeData, 1, corpusFrames, CORPUS_FRAMES, 20, NULL, NULL};
+    int length = MLX90641_Bench(&corpus, report, sizeof(report));
+
+    TEST_ASSERT_GREATER_THAN(0, length);
+    TEST_ASSERT_EQUAL_INT(length, (int)strlen(report));
+    TEST_MESSAGE(report);
+    TEST_ASSERT_NOT_NULL(strstr(report, "\"name\":\"HammingDecode\""));
+    TEST_ASSERT_NOT_NULL(strstr(report, "\"name\":\"MLX90641_CalculateToSimd\""));
+    assertErrors(report);
+}
+
+// without dumps the frame functions run against given parameters, as on the board,
+// with a compiled calibration of their own or the one given
+void test_bench_params()
+{
+    static uint16_t eeData[832];
+    static paramsMLX90641 params;
+    static calibMLX90641 calib;
+
+    memcpy(eeData, corpusEeData, sizeof(eeData));
+    HammingDecode(eeData);
+    TEST_ASSERT_EQUAL_INT(0, MLX90641_ExtractParameters(eeData, &params));
+    MLX90641_CompileParameters(&params, &calib);
+
+    MLX90641_BenchCorpus corpus = {NULL, 0, corpusFrames, 1, 5, &params, NULL};
+    for (int given = 0; given < 2; given++)
+    {
+        corpus.calib = given ? &calib : NULL;
+        int length = MLX90641_Bench(&corpus, report, sizeof(report));
+
+        TEST_ASSERT_GREATER_THAN(0, length);
+        TEST_ASSERT_NULL(strstr(report, "HammingDecode"));
+        TEST_ASSERT_NOT_NULL(strstr(report, "\"results\":[{\"name\":\"MLX90641_GetVdd\""));
+        assertErrors(report);
+    }
+}
+
+// the fast case switches the mode only around its own runs
+void test_bench_keeps_fast_to()
+{
+    MLX90641_BenchCorpus corpus = {corpusEeData, 1, corpusFrames, 1, 2, NULL, NULL};
+
+    MLX90641_SetFastTo(5.0f);
+    float before = MLX90641_GetFastToError();
+    TEST_ASSERT_GREATER_THAN(0, MLX90641_Bench(&corpus, report, sizeof(report)));
+    TEST_ASSERT_EQUAL_FLOAT(before, MLX90641_GetFastToError());
+    assertErrors(report);
+    MLX90641_SetFastTo(0);
+}
+
+void test_bench_rejects()
+{
+    MLX90641_BenchCorpus corpus = {NULL, 0, corpusFrames, 1, 5, NULL, NULL};
+
+    TEST_ASSERT_EQUAL_INT(-1, MLX90641_Bench(&corpus, report, sizeof(report)));
+
+    corpus.eeData = corpusEeData;
+    corpus.eeCount = 1;
+    TEST_ASSERT_EQUAL_INT(-1, MLX90641_Bench(&corpus, report, 64));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_corpus);
+    RUN_TEST(test_bench_params);
+    RUN_TEST(test_bench_keeps_fast_to);
+    RUN_TEST(test_bench_rejects);
+    return UNITY_END();
+}
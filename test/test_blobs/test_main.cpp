@@ -0,0 +1,226 @@
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "blobs.h"
+
+// findBlobs against a plain breadth first labeller on random masks of both
+// sensor resolutions. Blobs of equal area may come in any order, so the lists
+// are compared as sets, and only the areas by position.
+
+#define MAX_PIXELS (32 * 24)
+
+struct Reference
+{
+    int count;
+    Blob blobs[MAX_PIXELS];
+};
+
+static uint32_t seed;
+
+// fixed generator so every platform sees the same frames
+static uint32_t nextRandom()
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static float randomUnit()
+{
+    return (nextRandom() & 0xFFFF) / 65536.0f;
+}
+
+static void label(const FrameMask &mask, const float *frame, uint16_t minArea, Reference &out)
+{
+    static int labels[MAX_PIXELS];
+    static int queue[MAX_PIXELS];
+    const int rows = mask.rows;
+    const int cols = mask.cols;
+
+    memset(labels, 0, sizeof(labels));
+    out.count = 0;
+    int next = 0;
+
+    for (int start = 0; start < rows * cols; start++)
+    {
+        if (!maskTest(mask, start / cols, start % cols) || labels[start] != 0)
+        {
+            continue;
+        }
+
+        int head = 0;
+        int tail = 0;
+        next++;
+        labels[start] = next;
+        queue[tail++] = start;
+        while (head < tail)
+        {
+            int p = queue[head++];
+            for (int dr = -1; dr <= 1; dr++)
+            {
+                for (int dc = -1; dc <= 1; dc++)
+                {
+                    int r = p / cols + dr;
+                    int c = p % cols + dc;
+                    if (r >= 0 && c >= 0 && r < rows && c < cols && maskTest(mask, r, c) && labels[r * cols + c] == 0)
+                    {
+                        labels[r * cols + c] = next;
+                        queue[tail++] = r * cols + c;
+                    }
+                }
+            }
+        }
+        if (tail < minArea)
+        {
+            continue;
+        }
+
+        // statistics in row order, so the peak is the first hottest pixel
+        Blob &blob = out.blobs[out.count++];
+        double sumRow = 0;
+        double sumCol = 0;
+        memset(&blob, 0, sizeof(blob));
+        blob.top = 255;
+        blob.left = 255;
+        blob.peak = -INFINITY;
+        for (int p = start; p < rows * cols; p++)
+        {
+            if (labels[p] != next)
+            {
+                continue;
+            }
+            int r = p / cols;
+            int c = p % cols;
+            blob.area++;
+            sumRow += r;
+            sumCol += c;
+            blob.top = r < blob.top ? r : blob.top;
+            blob.bottom = r > blob.bottom ? r : blob.bottom;
+            blob.left = c < blob.left ? c : blob.left;
+            blob.right = c > blob.right ? c : blob.right;
+            if (frame[p] > blob.peak)
+            {
+                blob.peak = frame[p];
+                blob.peakIndex = p;
+            }
+        }
+        blob.centroidRow = sumRow / blob.area;
+        blob.centroidCol = sumCol / blob.area;
+    }
+
+    // biggest first
+    for (int i = 1; i < out.count; i++)
+    {
+        Blob blob = out.blobs[i];
+        int j = i;
+        for (; j > 0 && out.blobs[j - 1].area < blob.area; j--)
+        {
+            out.blobs[j] = out.blobs[j - 1];
+        }
+        out.blobs[j] = blob;
+    }
+}
+
+static bool same(const Blob &a, const Blob &b)
+{
+    return a.area == b.area && a.top == b.top && a.left == b.left && a.bottom == b.bottom && a.right == b.right &&
+           a.peak == b.peak && a.peakIndex == b.peakIndex && fabsf(a.centroidRow - b.centroidRow) < 1e-4f &&
+           fabsf(a.centroidCol - b.centroidCol) < 1e-4f;
+}
+
+// number of frames where findBlobs and the reference disagree
+template <int Rows, int Cols>
+static int compare(int frames, uint16_t minArea)
+{
+    static BlobWorkspace<Rows, Cols> workspace;
+    static Reference reference;
+    static float frame[Rows * Cols];
+    FrameMask mask;
+    BlobList list;
+    int mismatches = 0;
+
+    for (int n = 0; n < frames; n++)
+    {
+        float density = randomUnit();
+        for (int i = 0; i < Rows * Cols; i++)
+        {
+            frame[i] = randomUnit() < density ? 30 + 5 * randomUnit() : 20;
+            // every tenth frame a checkerboard of single pixels, the most labels a frame can need
+            if (n % 10 == 0)
+            {
+                frame[i] = (i / Cols) % 2 == 0 && (i % Cols) % 2 == 0 ? 31 : 20;
+            }
+        }
+        maskThreshold(mask, frame, Rows, Cols, 25);
+        findBlobs(mask, frame, minArea, workspace, list);
+        label(mask, frame, minArea, reference);
+
+        int expected = reference.count < BLOB_MAX_BLOBS ? reference.count : BLOB_MAX_BLOBS;
+        bool ok = list.count == expected && list.overflow == (reference.count > BLOB_MAX_BLOBS);
+        for (int i = 0; ok && i < expected; i++)
+        {
+            bool found = false;
+            for (int j = 0; j < reference.count && !found; j++)
+            {
+                found = same(list.blobs[i], reference.blobs[j]);
+            }
+            ok = found && list.blobs[i].area == reference.blobs[i].area;
+        }
+        mismatches += !ok;
+    }
+
+    return mismatches;
+}
+
+void setUp()
+{
+    seed = 5;
+}
+
+void tearDown()
+{
+}
+
+void test_random_16x12()
+{
+    TEST_ASSERT_EQUAL_INT(0, (compare<16, 12>(5000, 1)));
+}
+
+void test_random_32x24()
+{
+    TEST_ASSERT_EQUAL_INT(0, (compare<24, 32>(5000, 1)));
+}
+
+void test_min_area()
+{
+    TEST_ASSERT_EQUAL_INT(0, (compare<16, 12>(2000, 3)));
+    TEST_ASSERT_EQUAL_INT(0, (compare<24, 32>(2000, 4)));
+}
+
+// a workspace sized for the small sensor flags the large frame instead of
+// overrunning its labels
+void test_workspace_too_small()
+{
+    static BlobWorkspace<16, 12> workspace;
+    static float frame[24 * 32];
+    FrameMask mask;
+    BlobList list;
+
+    for (int i = 0; i < 24 * 32; i++)
+    {
+        frame[i] = 31;
+    }
+    maskThreshold(mask, frame, 24, 32, 25);
+    findBlobs(mask, frame, 1, workspace, list);
+    TEST_ASSERT_TRUE(list.overflow);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_random_16x12);
+    RUN_TEST(test_random_32x24);
+    RUN_TEST(test_min_area);
+    RUN_TEST(test_workspace_too_small);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+#include <unity.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MLX90641_API.h"
+#include "MLX90641_Cache.h"
+#include "MLX90641_I2C_Sim.h"
+#include "../mlx90641_corpus.h"
+
+// The calibration cache on a real file, against the simulated sensor: every kind
+// of bad entry has to fall back to the EEPROM and rewrite the cache.
+
+#define SLAVE 0x33
+#define CACHE_PATH "test_cache.cal"
+
+static uint16_t eeData[832];
+static paramsMLX90641 reference;
+static paramsMLX90641 params;
+
+struct Boot
+{
+    int cacheStatus;    // MLX90641_CacheLoad result
+    uint32_t busUs;     // time on the bus until the parameters are ready
+    uint32_t transactions;
+};
+
+// loadCalibration() of the firmware, timed on the simulated bus
+static Boot boot()
+{
+    MLX90641_SimTiming timing = {400, 0, 50000};
+    MLX90641_I2CStats stats;
+    Boot result;
+    uint16_t id[3];
+
+    MLX90641_SimInit(SLAVE, eeData);
+    MLX90641_SimSetTiming(&timing);
+    MLX90641_I2CSetBackend(MLX90641_SimBackend());
+    MLX90641_I2CResetStats();
+    memset(&params, 0, sizeof(params));
+    uint64_t start = MLX90641_SimGetTimeNs();
+
+    result.cacheStatus = -1;
+    if (MLX90641_ReadDeviceId(SLAVE, id) == 0)
+    {
+        result.cacheStatus = MLX90641_CacheLoad(MLX90641_FileStorage(), CACHE_PATH, id, &params);
+    }
+    if (result.cacheStatus != 0)
+    {
+        uint16_t dump[832];
+        MLX90641_DumpEE(SLAVE, dump);
+        MLX90641_ExtractParameters(dump, &params);
+        MLX90641_CacheSave(MLX90641_FileStorage(), CACHE_PATH, id, &params);
+    }
+
+    result.busUs = (uint32_t)((MLX90641_SimGetTimeNs() - start) / 1000);
+    MLX90641_I2CGetStats(&stats);
+    result.transactions = stats.transactions;
+    return result;
+}
+
+// overwrites size bytes of the cache file at offset
+static void patch(long offset, const void *data, size_t size)
+{
+    FILE *file = fopen(CACHE_PATH, "r+b");
+    TEST_ASSERT_NOT_NULL(file);
+    fseek(file, offset, SEEK_SET);
+    fwrite(data, 1, size, file);
+    fclose(file);
+}
+
+// a miss that went back to the EEPROM and left a good entry behind
+static void assertFallback(const Boot &miss, int status)
+{
+    TEST_ASSERT_EQUAL_INT(status, miss.cacheStatus);
+    TEST_ASSERT_GREATER_THAN(1, miss.transactions);
+    TEST_ASSERT_EQUAL_MEMORY(&reference, &params, sizeof(params));
+
+    Boot warm = boot();
+    TEST_ASSERT_EQUAL_INT(0, warm.cacheStatus);
+    TEST_ASSERT_EQUAL_MEMORY(&reference, &params, sizeof(params));
+}
+
+void setUp()
+{
+    uint16_t dump[832];
+
+    memcpy(eeData, corpusEeData, sizeof(eeData));
+    eeData[7] = 0x1234;
+    eeData[8] = 0x5678;
+    eeData[9] = 0x9ABC;
+    MLX90641_SimInit(SLAVE, eeData);
+    MLX90641_I2CSetBackend(MLX90641_SimBackend());
+    MLX90641_DumpEE(SLAVE, dump);
+    MLX90641_ExtractParameters(dump, &reference);
+    remove(CACHE_PATH);
+}
+
+void tearDown()
+{
+    remove(CACHE_PATH);
+}
+
+// boot time with and without the cache
+void test_cold_then_warm()
+{
+    char message[128];
+
+    Boot cold = boot();
+    Boot warm = boot();
+
+    TEST_ASSERT_EQUAL_INT(-1, cold.cacheStatus);
+    TEST_ASSERT_EQUAL_INT(0, warm.cacheStatus);
+    TEST_ASSERT_EQUAL_MEMORY(&reference, &params, sizeof(params));
+    snprintf(message, sizeof(message), "calibration: cold %u us / %u transactions, warm %u us / %u transactions",
+             (unsigned)cold.busUs, (unsigned)cold.transactions, (unsigned)warm.busUs, (unsigned)warm.transactions);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_THAN(cold.busUs / 20, warm.busUs);
+    TEST_ASSERT_EQUAL_UINT32(1, warm.transactions);
+}
+
+void test_corrupt_crc()
+{
+    uint8_t garbage = 0x55;
+
+    boot();
+    patch(sizeof(MLX90641_CacheHeader) + 100, &garbage, 1);
+    assertFallback(boot(), -4);
+}
+
+// e.g. power lost while the entry was written
+void test_truncated()
+{
+    static uint8_t entry[sizeof(MLX90641_CacheHeader) + 100];
+    const MLX90641_Storage *storage = MLX90641_FileStorage();
+
+    boot();
+    TEST_ASSERT_EQUAL_INT(sizeof(entry), storage->read(CACHE_PATH, 0, entry, sizeof(entry)));
+    storage->write(CACHE_PATH, entry, sizeof(entry));
+    assertFallback(boot(), -4);
+}
+
+void test_other_sensor()
+{
+    uint16_t dump[832];
+
+    boot();
+    eeData[8] ^= 0x0001;
+    MLX90641_SimInit(SLAVE, eeData);
+    MLX90641_DumpEE(SLAVE, dump);
+    MLX90641_ExtractParameters(dump, &reference);
+
+    assertFallback(boot(), -3);
+}
+
+void test_version_mismatch()
+{
+    uint16_t version = MLX90641_CACHE_VERSION + 1;
+
+    boot();
+    patch(offsetof(MLX90641_CacheHeader, version), &version, sizeof(version));
+    assertFallback(boot(), -2);
+}
+
+void test_layout_mismatch()
+{
+    uint16_t size = sizeof(paramsMLX90641) - 4;
+
+    boot();
+    patch(offsetof(MLX90641_CacheHeader, size), &size, sizeof(size));
+    assertFallback(boot(), -2);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_cold_then_warm);
+    RUN_TEST(test_corrupt_crc);
+    RUN_TEST(test_truncated);
+    RUN_TEST(test_other_sensor);
+    RUN_TEST(test_version_mismatch);
+    RUN_TEST(test_layout_mismatch);
+    return UNITY_END();
+}
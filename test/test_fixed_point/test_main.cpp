@@ -0,0 +1,112 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "MLX90641_API.h"
+#include "MLX90641_I2C_Sim.h"
+#include "../mlx90641_corpus.h"
+
+// MLX90641_CalculateToQ against the float reference over the whole sensor range,
+// the bound documented in MLX90641_API.h
+
+#define MAX_ERROR 0.02f
+
+int HammingDecode(uint16_t *eeData);
+
+static paramsMLX90641 params;
+
+void setUp()
+{
+    static uint16_t eeData[832];
+
+    memcpy(eeData, corpusEeData, sizeof(eeData));
+    HammingDecode(eeData);
+    MLX90641_ExtractParameters(eeData, &params);
+}
+
+void tearDown()
+{
+}
+
+// largest |CalculateToQ - CalculateTo| over scenes sweeping -40..300C in 0.1C steps,
+// and of GetTaQ - GetTa on the way
+static float sweep(float ta, float emissivity, float *taError)
+{
+    uint16_t frameData[242];
+    float scene[192];
+    float reference[192];
+    int16_t result[192];
+    float maxError = 0;
+    int step = 0;
+
+    *taError = 0;
+    for (int subPage = 0; step <= 3400; subPage ^= 1)
+    {
+        for (int i = 0; i < 192; i++, step++)
+        {
+            scene[i] = -40.0f + (step <= 3400 ? step : 3400) * 0.1f;
+        }
+        MLX90641_SimSyntheticFrame(&params, scene, ta, subPage, frameData);
+
+        float taFloat = MLX90641_GetTa(frameData, &params);
+        int32_t taQ = MLX90641_GetTaQ(frameData, &params);
+        *taError = fmaxf(*taError, fabsf(taQ / 65536.0f - taFloat));
+
+        MLX90641_CalculateTo(frameData, &params, emissivity, taFloat - 8.0f, reference);
+        MLX90641_CalculateToQ(frameData, &params, (uint16_t)lroundf(emissivity * 32768), taQ - (8 << 16), result, NULL,
+                              NULL);
+        for (int i = 0; i < 192; i++)
+        {
+            float error = fabsf(result[i] * 0.01f - reference[i]);
+            maxError = error > maxError ? error : maxError;
+        }
+    }
+
+    return maxError;
+}
+
+void test_vdd()
+{
+    for (int f = 0; f < CORPUS_FRAMES; f++)
+    {
+        uint16_t *frameData = (uint16_t *)&corpusFrames[f * 242];
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, MLX90641_GetVdd(frameData, &params),
+                                 MLX90641_GetVddQ(frameData, &params) / 1048576.0f);
+    }
+}
+
+void test_range_room()
+{
+    float taError;
+    float toError = sweep(25.0f, 0.95f, &taError);
+
+    TEST_ASSERT_FLOAT_WITHIN(MAX_ERROR, 0.0f, taError);
+    TEST_ASSERT_FLOAT_WITHIN(MAX_ERROR, 0.0f, toError);
+}
+
+void test_range_cold_ambient()
+{
+    float taError;
+    float toError = sweep(-10.0f, 1.0f, &taError);
+
+    TEST_ASSERT_FLOAT_WITHIN(MAX_ERROR, 0.0f, taError);
+    TEST_ASSERT_FLOAT_WITHIN(MAX_ERROR, 0.0f, toError);
+}
+
+void test_range_hot_ambient()
+{
+    float taError;
+    float toError = sweep(60.0f, 0.95f, &taError);
+
+    TEST_ASSERT_FLOAT_WITHIN(MAX_ERROR, 0.0f, taError);
+    TEST_ASSERT_FLOAT_WITHIN(MAX_ERROR, 0.0f, toError);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_vdd);
+    RUN_TEST(test_range_room);
+    RUN_TEST(test_range_cold_ambient);
+    RUN_TEST(test_range_hot_ambient);
+    return UNITY_END();
+}
@@ -0,0 +1,104 @@
+#include <unity.h>
+#include <string.h>
+#include "MLX90641_Frame.h"
+
+static MLX90641_FrameAssembler assembler;
+static const float *emitted;
+static int events;
+static int lastSubPage;
+
+static void onFrame(const float *to, uint8_t subPage, void *context)
+{
+    (void)context;
+    emitted = to;
+    lastSubPage = subPage;
+    events++;
+}
+
+// compensates a fake sub-page whose pixels all read value
+static int feed(uint8_t subPage, float value)
+{
+    uint16_t frameData[242] = {};
+
+    frameData[241] = subPage;
+    float *to = MLX90641_FrameBegin(&assembler, frameData);
+    for (int i = 0; i < 192; i++)
+    {
+        to[i] = value;
+    }
+    return MLX90641_FrameEnd(&assembler);
+}
+
+void setUp()
+{
+    MLX90641_FrameInit(&assembler, onFrame, NULL);
+    emitted = NULL;
+    events = 0;
+    lastSubPage = -1;
+}
+
+void tearDown()
+{
+}
+
+// every sub-page is a frame, including the very first one after start-up
+void test_every_sub_page_completes()
+{
+    TEST_ASSERT_NULL(MLX90641_FrameLatest(&assembler));
+
+    for (int n = 0; n < 6; n++)
+    {
+        TEST_ASSERT_EQUAL_INT(1, feed(n & 1, (float)n));
+        TEST_ASSERT_EQUAL_INT(n + 1, events);
+        TEST_ASSERT_EQUAL_INT(n & 1, lastSubPage);
+        TEST_ASSERT_EQUAL_FLOAT((float)n, emitted[0]);
+        TEST_ASSERT_TRUE(emitted == MLX90641_FrameLatest(&assembler));
+    }
+    TEST_ASSERT_EQUAL_UINT32(6, assembler.frames);
+}
+
+// the emitted values survive the next sub-page, which goes to the other slot
+void test_double_buffered()
+{
+    feed(0, 1.0f);
+    const float *first = emitted;
+    feed(1, 2.0f);
+
+    TEST_ASSERT_TRUE(first != emitted);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, first[191]);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, emitted[191]);
+}
+
+// the same sub-page twice in a row, e.g. after a missed read, still keeps the
+// previous frame intact
+void test_same_sub_page_flips_slot()
+{
+    feed(0, 1.0f);
+    const float *first = emitted;
+    feed(0, 2.0f);
+
+    TEST_ASSERT_TRUE(first != emitted);
+    TEST_ASSERT_EQUAL_INT(0, lastSubPage);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, first[191]);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, emitted[191]);
+}
+
+void test_reset()
+{
+    feed(0, 1.0f);
+    MLX90641_FrameReset(&assembler);
+    TEST_ASSERT_NULL(MLX90641_FrameLatest(&assembler));
+
+    TEST_ASSERT_EQUAL_INT(1, feed(1, 3.0f));
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, MLX90641_FrameLatest(&assembler)[0]);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_every_sub_page_completes);
+    RUN_TEST(test_double_buffered);
+    RUN_TEST(test_same_sub_page_flips_slot);
+    RUN_TEST(test_reset);
+    return UNITY_END();
+}
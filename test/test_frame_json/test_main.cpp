@@ -0,0 +1,185 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "frame_json.h"
+
+// The streamed /raw payload against a fixture, byte for byte, and against a
+// printf built reference for payloads around the FRAME_JSON_CHUNK_BYTES edge.
+
+static const char fixture[] =
+    "{\"sensor\":\"MLX90641\",\"rows\":2,\"cols\":3,\"data\":\"22.35,-0.05,nan,-12.00,0.00,300.99\","
+    "\"temp\":23.50,\"avg\":23.50,\"min\":-12.00,\"max\":300.99,\"min_index\":3,\"max_index\":5,"
+    "\"overflow\":false,\"movingAverageEnabled\":true,\"person_detected\":true,\"person_count\":1,"
+    "\"tracks\":[{\"id\":7,\"row\":1.25,\"col\":null}],\"line_in\":2,\"line_out\":4000000000}";
+
+struct Capture
+{
+    std::string body;
+    std::vector<size_t> pieces;
+};
+
+static void capture(const char *data, size_t length, void *context)
+{
+    Capture *out = (Capture *)context;
+    out->body.append(data, length);
+    out->pieces.push_back(length);
+}
+
+static FrameSummary summary()
+{
+    FrameSummary summary;
+
+    memset(&summary, 0, sizeof(summary));
+    summary.avg = 23.5f;
+    summary.min = -12.0f;
+    summary.max = 300.99f;
+    summary.minIndex = 3;
+    summary.maxIndex = 5;
+    summary.movingAverageEnabled = true;
+    summary.personDetected = true;
+    summary.personCount = 1;
+    summary.trackCount = 1;
+    summary.tracks[0].id = 7;
+    summary.tracks[0].row = 1.25f;
+    summary.tracks[0].col = NAN;
+    summary.lineIn = 2;
+    summary.lineOut = 4000000000u;
+    return summary;
+}
+
+// the same payload built with printf
+static std::string reference(const char *sensor, int pixels, const int16_t *centi)
+{
+    std::string out = std::string("{\"sensor\":\"") + sensor + "\",\"rows\":1,\"cols\":" + std::to_string(pixels) +
+                      ",\"data\":\"";
+    char number[32];
+
+    for (int i = 0; i < pixels; i++)
+    {
+        int magnitude = centi[i] < 0 ? -centi[i] : centi[i];
+        snprintf(number, sizeof(number), "%s%s%d.%02d", i ? "," : "", centi[i] < 0 ? "-" : "", magnitude / 100,
+                 magnitude % 100);
+        out += number;
+    }
+    return out + "\",\"temp\":23.50,\"avg\":23.50,\"min\":-12.00,\"max\":300.99,\"min_index\":3,\"max_index\":5,"
+                 "\"overflow\":false,\"movingAverageEnabled\":true,\"person_detected\":true,\"person_count\":1,"
+                 "\"tracks\":[{\"id\":7,\"row\":1.25,\"col\":null}],\"line_in\":2,\"line_out\":4000000000}";
+}
+
+static void assertPieces(const Capture &out, size_t total)
+{
+    size_t sum = 0;
+
+    for (size_t length : out.pieces)
+    {
+        TEST_ASSERT_GREATER_THAN(0, (int)length);
+        TEST_ASSERT_LESS_OR_EQUAL(FRAME_JSON_CHUNK_BYTES, (int)length);
+        sum += length;
+    }
+    TEST_ASSERT_EQUAL_UINT32(total, sum);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_fixture()
+{
+    const int16_t centi[6] = {2235, -5, FRAME_JSON_INVALID, -1200, 0, 30099};
+    FrameSummary values = summary();
+    Capture out;
+
+    size_t total = frameJsonStream("MLX90641", 2, 3, centi, values, capture, &out);
+
+    TEST_ASSERT_EQUAL_STRING(fixture, out.body.c_str());
+    TEST_ASSERT_EQUAL_UINT32(strlen(fixture), total);
+    TEST_ASSERT_EQUAL_INT(1, (int)out.pieces.size());
+}
+
+// frames of 1..400 pixels with numbers of every width, so a number lands on
+// and around every position of the chunk edge
+void test_chunk_edges()
+{
+    static int16_t centi[400];
+    FrameSummary values = summary();
+    int chunked = 0;
+
+    for (int i = 0; i < 400; i++)
+    {
+        static const int16_t widths[] = {5, -5, 123, -1234, 32000, -32000, 2250, 999};
+        centi[i] = widths[i % 8] + i;
+    }
+
+    for (int pixels = 1; pixels <= 400; pixels++)
+    {
+        Capture out;
+        size_t total = frameJsonStream("MLX90641", 1, pixels, centi, values, capture, &out);
+        std::string expected = reference("MLX90641", pixels, centi);
+
+        TEST_ASSERT_EQUAL_UINT32(expected.size(), total);
+        TEST_ASSERT_TRUE(expected == out.body);
+        assertPieces(out, total);
+        chunked += out.pieces.size() > 1;
+    }
+    TEST_ASSERT_GREATER_THAN(300, chunked);
+}
+
+// payloads of exactly one chunk, one byte over, and text longer than a chunk
+void test_exact_chunk()
+{
+    const int16_t centi[1] = {2100};
+    FrameSummary values = summary();
+    std::string base = reference("", 1, centi);
+
+    for (int extra = -2; extra <= 2; extra++)
+    {
+        std::string sensor(FRAME_JSON_CHUNK_BYTES - base.size() + extra, 's');
+        Capture out;
+
+        size_t total = frameJsonStream(sensor.c_str(), 1, 1, centi, values, capture, &out);
+
+        TEST_ASSERT_EQUAL_UINT32(FRAME_JSON_CHUNK_BYTES + extra, total);
+        TEST_ASSERT_TRUE(reference(sensor.c_str(), 1, centi) == out.body);
+        TEST_ASSERT_EQUAL_INT(extra <= 0 ? 1 : 2, (int)out.pieces.size());
+        assertPieces(out, total);
+    }
+
+    std::string sensor(3 * FRAME_JSON_CHUNK_BYTES + 7, 'x');
+    Capture out;
+    size_t total = frameJsonStream(sensor.c_str(), 1, 1, centi, values, capture, &out);
+    TEST_ASSERT_TRUE(reference(sensor.c_str(), 1, centi) == out.body);
+    assertPieces(out, total);
+}
+
+void test_numbers()
+{
+    char out[FRAME_JSON_NUMBER_CHARS + 1];
+
+    out[frameJsonNumber(out, 22.345f)] = 0;
+    TEST_ASSERT_EQUAL_STRING("22.35", out);
+    out[frameJsonNumber(out, -0.001f)] = 0;
+    TEST_ASSERT_EQUAL_STRING("-0.00", out);
+    out[frameJsonNumber(out, -1e9f)] = 0;
+    TEST_ASSERT_EQUAL_STRING("-10000000.00", out);
+    out[frameJsonNumber(out, -INFINITY)] = 0;
+    TEST_ASSERT_EQUAL_STRING("-inf", out);
+    out[frameJsonCenti(out, INT16_MIN + 1)] = 0;
+    TEST_ASSERT_EQUAL_STRING("-327.67", out);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fixture);
+    RUN_TEST(test_chunk_edges);
+    RUN_TEST(test_exact_chunk);
+    RUN_TEST(test_numbers);
+    return UNITY_END();
+}
@@ -0,0 +1,272 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "MLX90641_Bench.h"
+#include "frame_mask.h"
+
+// The row-word mask operations against per pixel definitions, and the hot
+// pixel count of the detection against the getPixel() neighbour count it
+// replaced, timed on both sensor resolutions.
+
+#define MAX_PIXELS (32 * 32)
+
+static uint32_t seed;
+
+static uint32_t nextRandom()
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static float randomUnit()
+{
+    return (nextRandom() & 0xFFFF) / 65536.0f;
+}
+
+// random pixels of the given density, with NaN and negative zero sprinkled in
+static void randomFrame(float *frame, int pixels)
+{
+    float density = randomUnit();
+
+    for (int i = 0; i < pixels; i++)
+    {
+        frame[i] = randomUnit() < density ? 1.0f + 50 * randomUnit() : -5.0f - 50 * randomUnit();
+        if (nextRandom() % 50 == 0)
+        {
+            frame[i] = NAN;
+        }
+        if (nextRandom() % 70 == 0)
+        {
+            frame[i] = -0.0f;
+        }
+    }
+}
+
+static bool pixelSet(const FrameMask &mask, int r, int c)
+{
+    return r >= 0 && c >= 0 && r < mask.rows && c < mask.cols && maskTest(mask, r, c);
+}
+
+// mismatching pixels over frames random frames of rows x cols
+static int compareOperations(int rows, int cols, int frames)
+{
+    static float frame[MAX_PIXELS];
+    static const float thresholds[3] = {-10.0f, 0.0f, 20.0f};
+    const uint32_t outside = cols == 32 ? 0 : ~((1u << cols) - 1);
+    int mismatches = 0;
+
+    for (int n = 0; n < frames; n++)
+    {
+        FrameMask mask;
+        FrameMask neighbours;
+        FrameMask dilated;
+        FrameMask eroded;
+        float threshold = thresholds[n % 3];
+        int minimum = n % 10;
+
+        randomFrame(frame, rows * cols);
+        maskThreshold(mask, frame, rows, cols, threshold);
+        maskNeighbours(mask, minimum, neighbours);
+        maskDilate(mask, dilated);
+        maskErode(mask, eroded);
+
+        int count = 0;
+        for (int r = 0; r < rows; r++)
+        {
+            for (int c = 0; c < cols; c++)
+            {
+                int around = 0;
+                bool any = false;
+                bool all = true;
+                for (int dr = -1; dr <= 1; dr++)
+                {
+                    for (int dc = -1; dc <= 1; dc++)
+                    {
+                        bool set = pixelSet(mask, r + dr, c + dc);
+                        around += (dr != 0 || dc != 0) && set;
+                        any |= set;
+                        all &= set;
+                    }
+                }
+                count += maskTest(mask, r, c);
+                mismatches += maskTest(mask, r, c) != (frame[r * cols + c] > threshold);
+                mismatches += maskTest(neighbours, r, c) != (around >= minimum);
+                mismatches += maskTest(dilated, r, c) != any;
+                mismatches += maskTest(eroded, r, c) != all;
+            }
+            mismatches += ((neighbours.bits[r] | dilated.bits[r] | eroded.bits[r]) & outside) != 0;
+        }
+        mismatches += maskCount(mask) != count;
+        mismatches += maskAny(mask) != (count != 0);
+    }
+
+    return mismatches;
+}
+
+//------------------------------------------------------------------------------
+
+// The detection before the masks: frame[row][col] read through a bounds checked
+// getPixel(), pixels outside the frame read as 0C
+static const float *oldFrame;
+static int oldRows;
+static int oldCols;
+
+static float getPixel(int x, int y)
+{
+    if (x < oldRows && x >= 0 && y < oldCols && y >= 0)
+    {
+        return oldFrame[x * oldCols + y];
+    }
+    return (float)0.0;
+}
+
+static int getNeighboursCount(int r, int c, float threashold)
+{
+    int count = 0;
+
+    for (int dr = -1; dr <= 1; dr++)
+    {
+        for (int dc = -1; dc <= 1; dc++)
+        {
+            if ((dr != 0 || dc != 0) && getPixel(r + dr, c + dc) > threashold)
+            {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+static int oldHotCount(const float *frame, int rows, int cols, float threshold, int minNeighbours)
+{
+    int count = 0;
+
+    oldFrame = frame;
+    oldRows = rows;
+    oldCols = cols;
+    for (int r = 0; r < rows; r++)
+    {
+        for (int c = 0; c < cols; c++)
+        {
+            if (threshold < getPixel(r, c) && getNeighboursCount(r, c, threshold) >= minNeighbours)
+            {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+static int maskHotCount(const float *frame, int rows, int cols, float threshold, int minNeighbours)
+{
+    FrameMask hot;
+    FrameMask neighbours;
+
+    maskThreshold(hot, frame, rows, cols, threshold);
+    maskNeighbours(hot, minNeighbours, neighbours);
+    maskAnd(hot, neighbours, hot);
+    return maskCount(hot);
+}
+
+// a 22C room with a person sized warm patch at a different place in every frame
+static void scene(float *frame, int rows, int cols, int k)
+{
+    int personRow = k % rows;
+    int personCol = (k * 3) % cols;
+
+    for (int i = 0; i < rows * cols; i++)
+    {
+        int dr = i / cols - personRow;
+        int dc = i % cols - personCol;
+        frame[i] = 21.7f + 0.6f * randomUnit();
+        if (dr * dr <= rows * rows / 25 && dc * dc <= cols * cols / 36)
+        {
+            frame[i] += 9;
+        }
+    }
+}
+
+static void benchmark(int rows, int cols)
+{
+    const int frames = 32;
+    const int runs = 20000;
+    static float scenes[frames][MAX_PIXELS];
+    long oldSum = 0;
+    long maskSum = 0;
+    char message[128];
+
+    for (int k = 0; k < frames; k++)
+    {
+        scene(scenes[k], rows, cols, k);
+        TEST_ASSERT_EQUAL_INT(oldHotCount(scenes[k], rows, cols, 26, 2), maskHotCount(scenes[k], rows, cols, 26, 2));
+    }
+
+    uint64_t start = MLX90641_BenchNowNs();
+    for (int n = 0; n < runs; n++)
+    {
+        oldSum += oldHotCount(scenes[n % frames], rows, cols, 26, 2);
+    }
+    uint64_t oldNs = MLX90641_BenchNowNs() - start;
+
+    start = MLX90641_BenchNowNs();
+    for (int n = 0; n < runs; n++)
+    {
+        maskSum += maskHotCount(scenes[n % frames], rows, cols, 26, 2);
+    }
+    uint64_t maskNs = MLX90641_BenchNowNs() - start;
+
+    snprintf(message, sizeof(message), "%d rows x %d cols, hot with 2 hot neighbours: getPixel %.0f ns, masks %.0f ns",
+             rows, cols, (double)oldNs / runs, (double)maskNs / runs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_INT(oldSum, maskSum);
+}
+
+//------------------------------------------------------------------------------
+
+void setUp()
+{
+    seed = 2;
+}
+
+void tearDown()
+{
+}
+
+void test_operations_16x12()
+{
+    TEST_ASSERT_EQUAL_INT(0, compareOperations(16, 12, 5000));
+}
+
+void test_operations_32x24()
+{
+    TEST_ASSERT_EQUAL_INT(0, compareOperations(24, 32, 5000));
+}
+
+void test_operations_edges()
+{
+    TEST_ASSERT_EQUAL_INT(0, compareOperations(1, 1, 500));
+    TEST_ASSERT_EQUAL_INT(0, compareOperations(3, 31, 500));
+    TEST_ASSERT_EQUAL_INT(0, compareOperations(32, 32, 500));
+}
+
+void test_benchmark_16x12()
+{
+    benchmark(16, 12);
+}
+
+void test_benchmark_32x24()
+{
+    benchmark(24, 32);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_operations_16x12);
+    RUN_TEST(test_operations_32x24);
+    RUN_TEST(test_operations_edges);
+    RUN_TEST(test_benchmark_16x12);
+    RUN_TEST(test_benchmark_32x24);
+    return UNITY_END();
+}
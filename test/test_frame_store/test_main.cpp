@@ -0,0 +1,235 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "frame_store.h"
+
+#define READERS 3
+#define STRESS_MS 1000
+
+static FrameStore store;
+
+// every field is derived from the sequence, so a torn copy cannot pass
+static void fill(StoredFrame &frame)
+{
+    uint32_t sequence = frame.sequence;
+
+    frame.timestamp = sequence * 3;
+    frame.rows = 16;
+    frame.cols = 12;
+    frame.ta = (int16_t)sequence;
+    frame.summary.minIndex = (uint8_t)sequence;
+    frame.summary.lineIn = sequence;
+    for (int i = 0; i < FRAME_STORE_MAX_PIXELS; i++)
+    {
+        frame.pixels[i] = (int16_t)(sequence * 7 + i);
+    }
+}
+
+static bool consistent(const StoredFrame &frame)
+{
+    uint32_t sequence = frame.sequence;
+
+    if (frame.timestamp != sequence * 3 || frame.ta != (int16_t)sequence ||
+        frame.summary.minIndex != (uint8_t)sequence || frame.summary.lineIn != sequence)
+    {
+        return false;
+    }
+    for (int i = 0; i < FRAME_STORE_MAX_PIXELS; i++)
+    {
+        if (frame.pixels[i] != (int16_t)(sequence * 7 + i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void produce()
+{
+    StoredFrame *frame = frameStoreBegin(store);
+    fill(*frame);
+    frameStorePublish(store);
+}
+
+void setUp()
+{
+    memset((void *)&store, 0, sizeof(store));
+}
+
+void tearDown()
+{
+}
+
+void test_single_thread()
+{
+    StoredFrame frame;
+
+    TEST_ASSERT_FALSE(frameStoreRead(store, 0, frame));
+
+    produce();
+    TEST_ASSERT_TRUE(frameStoreRead(store, 0, frame));
+    TEST_ASSERT_EQUAL_UINT32(1, frame.sequence);
+    TEST_ASSERT_TRUE(consistent(frame));
+
+    produce();
+    produce();
+    TEST_ASSERT_TRUE(frameStoreRead(store, 0, frame));
+    TEST_ASSERT_EQUAL_UINT32(3, frame.sequence);
+    TEST_ASSERT_TRUE(frameStoreRead(store, 2, frame));
+    TEST_ASSERT_EQUAL_UINT32(2, frame.sequence);
+    TEST_ASSERT_TRUE(consistent(frame));
+    // only the latest two frames are kept
+    TEST_ASSERT_FALSE(frameStoreRead(store, 1, frame));
+}
+
+// the slot of the previous frame is the one being written
+void test_read_during_write()
+{
+    StoredFrame frame;
+
+    produce();
+    produce();
+    StoredFrame *next = frameStoreBegin(store);
+
+    TEST_ASSERT_FALSE(frameStoreRead(store, 1, frame));
+    TEST_ASSERT_TRUE(frameStoreRead(store, 0, frame));
+    TEST_ASSERT_EQUAL_UINT32(2, frame.sequence);
+
+    fill(*next);
+    frameStorePublish(store);
+    TEST_ASSERT_TRUE(frameStoreRead(store, 0, frame));
+    TEST_ASSERT_EQUAL_UINT32(3, frame.sequence);
+}
+
+void test_centi()
+{
+    TEST_ASSERT_EQUAL_INT16(2235, frameStoreCenti(22.35f));
+    TEST_ASSERT_EQUAL_INT16(-5, frameStoreCenti(-0.05f));
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX, frameStoreCenti(1000.0f));
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN + 1, frameStoreCenti(-1000.0f));
+    TEST_ASSERT_EQUAL_INT16(FRAME_STORE_INVALID, frameStoreCenti(NAN));
+}
+
+// a producer publishing as fast as it can against readers of the latest and
+// the previous frame: no copy may be torn and the latest never goes backwards
+void test_concurrent_readers()
+{
+    std::atomic<bool> stop(false);
+    std::atomic<long> reads(0);
+    std::atomic<long> torn(0);
+    std::atomic<long> backwards(0);
+    std::thread readers[READERS];
+
+    std::thread producer([&] {
+        while (!stop)
+        {
+            produce();
+        }
+    });
+    for (std::thread &reader : readers)
+    {
+        reader = std::thread([&] {
+            StoredFrame latest;
+            StoredFrame previous;
+            uint32_t last = 0;
+
+            while (!stop)
+            {
+                if (!frameStoreRead(store, 0, latest))
+                {
+                    continue;
+                }
+                reads++;
+                torn += !consistent(latest);
+                backwards += latest.sequence < last;
+                last = latest.sequence;
+
+                // whether the previous frame is still there depends on the
+                // scheduling; test_previous_across_threads pins that down
+                if (latest.sequence > 1 && frameStoreRead(store, latest.sequence - 1, previous))
+                {
+                    torn += !consistent(previous) || previous.sequence + 1 != latest.sequence;
+                }
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(STRESS_MS));
+    stop = true;
+    producer.join();
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, torn.load());
+    TEST_ASSERT_EQUAL_INT(0, backwards.load());
+    TEST_ASSERT_GREATER_THAN(1000, (int)store.latest.load());
+    TEST_ASSERT_GREATER_THAN(1000, (int)reads.load());
+}
+
+static void waitFor(const std::atomic<int> &step, int value)
+{
+    while (step.load() < value)
+    {
+        std::this_thread::yield();
+    }
+}
+
+// the producer is held at fixed points so the reader sees the previous frame
+// while the producer is idle and loses it once the producer starts writing
+// its slot, independent of the scheduling
+void test_previous_across_threads()
+{
+    std::atomic<int> producerStep(0);
+    std::atomic<int> readerStep(0);
+
+    std::thread producer([&] {
+        produce();
+        produce();
+        producerStep = 1;
+        waitFor(readerStep, 1);
+
+        StoredFrame *next = frameStoreBegin(store);
+        producerStep = 2;
+        waitFor(readerStep, 2);
+        fill(*next);
+        frameStorePublish(store);
+    });
+
+    StoredFrame frame;
+
+    waitFor(producerStep, 1);
+    TEST_ASSERT_TRUE(frameStoreRead(store, 1, frame));
+    TEST_ASSERT_EQUAL_UINT32(1, frame.sequence);
+    TEST_ASSERT_TRUE(consistent(frame));
+    readerStep = 1;
+
+    waitFor(producerStep, 2);
+    TEST_ASSERT_FALSE(frameStoreRead(store, 1, frame));
+    TEST_ASSERT_TRUE(frameStoreRead(store, 0, frame));
+    TEST_ASSERT_EQUAL_UINT32(2, frame.sequence);
+    TEST_ASSERT_TRUE(consistent(frame));
+    readerStep = 2;
+
+    producer.join();
+    TEST_ASSERT_TRUE(frameStoreRead(store, 2, frame));
+    TEST_ASSERT_EQUAL_UINT32(2, frame.sequence);
+    TEST_ASSERT_TRUE(frameStoreRead(store, 0, frame));
+    TEST_ASSERT_EQUAL_UINT32(3, frame.sequence);
+    TEST_ASSERT_TRUE(consistent(frame));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_single_thread);
+    RUN_TEST(test_read_during_write);
+    RUN_TEST(test_centi);
+    RUN_TEST(test_previous_across_threads);
+    RUN_TEST(test_concurrent_readers);
+    return UNITY_END();
+}
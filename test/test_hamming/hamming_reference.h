@@ -0,0 +1,155 @@
+/**
+ * @copyright (C) 2017 Melexis N.V.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef HAMMING_REFERENCE_H
+#define HAMMING_REFERENCE_H
+
+#include <stdint.h>
+
+// HammingDecode as shipped in the Melexis library, kept unchanged as the
+// reference for the table driven decoder in MLX90641_API.cpp
+static int HammingDecodeReference(uint16_t *eeData)
+{
+    int error = 0;
+    int16_t parity[5];
+    int8_t D[16];
+    int16_t check;
+    uint16_t data;
+    uint16_t mask;
+
+    for (int addr = 16; addr < 832; addr++)
+    {
+        parity[0] = -1;
+        parity[1] = -1;
+        parity[2] = -1;
+        parity[3] = -1;
+        parity[4] = -1;
+
+        data = eeData[addr];
+
+        mask = 1;
+        for (int i = 0; i < 16; i++)
+        {
+            D[i] = (data & mask) >> i;
+            mask = mask << 1;
+        }
+
+        parity[0] = D[0] ^ D[1] ^ D[3] ^ D[4] ^ D[6] ^ D[8] ^ D[10] ^ D[11];
+        parity[1] = D[0] ^ D[2] ^ D[3] ^ D[5] ^ D[6] ^ D[9] ^ D[10] ^ D[12];
+        parity[2] = D[1] ^ D[2] ^ D[3] ^ D[7] ^ D[8] ^ D[9] ^ D[10] ^ D[13];
+        parity[3] = D[4] ^ D[5] ^ D[6] ^ D[7] ^ D[8] ^ D[9] ^ D[10] ^ D[14];
+        parity[4] = D[0] ^ D[1] ^ D[2] ^ D[3] ^ D[4] ^ D[5] ^ D[6] ^ D[7] ^ D[8] ^ D[9] ^ D[10] ^ D[11] ^ D[12] ^
+                    D[13] ^ D[14] ^ D[15];
+
+        if ((parity[0] != 0) || (parity[1] != 0) || (parity[2] != 0) || (parity[3] != 0) || (parity[4] != 0))
+        {
+            check = (parity[0] << 0) + (parity[1] << 1) + (parity[2] << 2) + (parity[3] << 3) + (parity[4] << 4);
+
+            if ((check > 15) && (check < 32))
+            {
+                switch (check)
+                {
+                case 16:
+                    D[15] = 1 - D[15];
+                    break;
+
+                case 24:
+                    D[14] = 1 - D[14];
+                    break;
+
+                case 20:
+                    D[13] = 1 - D[13];
+                    break;
+
+                case 18:
+                    D[12] = 1 - D[12];
+                    break;
+
+                case 17:
+                    D[11] = 1 - D[11];
+                    break;
+
+                case 31:
+                    D[10] = 1 - D[10];
+                    break;
+
+                case 30:
+                    D[9] = 1 - D[9];
+                    break;
+
+                case 29:
+                    D[8] = 1 - D[8];
+                    break;
+
+                case 28:
+                    D[7] = 1 - D[7];
+                    break;
+
+                case 27:
+                    D[6] = 1 - D[6];
+                    break;
+
+                case 26:
+                    D[5] = 1 - D[5];
+                    break;
+
+                case 25:
+                    D[4] = 1 - D[4];
+                    break;
+
+                case 23:
+                    D[3] = 1 - D[3];
+                    break;
+
+                case 22:
+                    D[2] = 1 - D[2];
+                    break;
+
+                case 21:
+                    D[1] = 1 - D[1];
+                    break;
+
+                case 19:
+                    D[0] = 1 - D[0];
+                    break;
+                }
+
+                if (error == 0)
+                {
+                    error = -9;
+                }
+
+                data = 0;
+                mask = 1;
+                for (int i = 0; i < 16; i++)
+                {
+                    data = data + D[i] * mask;
+                    mask = mask << 1;
+                }
+            }
+            else
+            {
+                error = -10;
+            }
+        }
+
+        eeData[addr] = data & 0x07FF;
+    }
+
+    return error;
+}
+
+#endif
@@ -0,0 +1,145 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MLX90641_Bench.h"
+#include "hamming_reference.h"
+#include "../mlx90641_corpus.h"
+
+int HammingDecode(uint16_t *eeData);
+
+static uint16_t expected[832];
+static uint16_t actual[832];
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// decodes the same dump with both decoders; data and error code must match
+static int compare()
+{
+    memcpy(actual, expected, sizeof(actual));
+    int expectedError = HammingDecodeReference(expected);
+    int actualError = HammingDecode(actual);
+
+    return expectedError == actualError && memcmp(expected, actual, sizeof(actual)) == 0;
+}
+
+// every 16 bit word: clean, corrected (-9) and uncorrectable (-10)
+void test_every_word()
+{
+    long mismatches = 0;
+    int codes[3] = {};
+
+    for (uint32_t word = 0; word < 65536; word++)
+    {
+        memset(expected, 0, sizeof(expected));
+        expected[16] = word;
+        if (!compare())
+        {
+            mismatches++;
+        }
+
+        memset(actual, 0, sizeof(actual));
+        actual[16] = word;
+        int error = HammingDecodeReference(actual);
+        codes[error == 0 ? 0 : error == -9 ? 1 : 2]++;
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, mismatches);
+    TEST_ASSERT_GREATER_THAN(0, codes[0]);
+    TEST_ASSERT_GREATER_THAN(0, codes[1]);
+    TEST_ASSERT_GREATER_THAN(0, codes[2]);
+}
+
+// the first error of a dump decides its code, in either order
+void test_error_order()
+{
+    uint16_t corrected = 0;
+    uint16_t uncorrectable = 0;
+
+    for (uint32_t word = 1; word < 65536 && (corrected == 0 || uncorrectable == 0); word++)
+    {
+        memset(expected, 0, sizeof(expected));
+        expected[16] = word;
+        int error = HammingDecodeReference(expected);
+        if (error == -9 && corrected == 0)
+        {
+            corrected = word;
+        }
+        if (error == -10 && uncorrectable == 0)
+        {
+            uncorrectable = word;
+        }
+    }
+
+    for (int order = 0; order < 2; order++)
+    {
+        memset(expected, 0, sizeof(expected));
+        expected[20] = order ? uncorrectable : corrected;
+        expected[30] = order ? corrected : uncorrectable;
+        TEST_ASSERT_TRUE(compare());
+    }
+}
+
+void test_random_dumps()
+{
+    srand(1);
+    for (int n = 0; n < 2000; n++)
+    {
+        for (int i = 0; i < 832; i++)
+        {
+            expected[i] = rand();
+        }
+        TEST_ASSERT_TRUE(compare());
+    }
+
+    memcpy(expected, corpusEeData, sizeof(expected));
+    TEST_ASSERT_TRUE(compare());
+}
+
+// ns per dump of both decoders over the recorded EEPROM
+void test_speed()
+{
+    const int runs = 2000;
+    uint64_t referenceNs;
+    uint64_t decodeNs;
+    uint64_t start;
+    char message[96];
+
+    start = MLX90641_BenchNowNs();
+    for (int n = 0; n < runs; n++)
+    {
+        memcpy(expected, corpusEeData, sizeof(expected));
+        HammingDecodeReference(expected);
+    }
+    referenceNs = MLX90641_BenchNowNs() - start;
+
+    start = MLX90641_BenchNowNs();
+    for (int n = 0; n < runs; n++)
+    {
+        memcpy(actual, corpusEeData, sizeof(actual));
+        HammingDecode(actual);
+    }
+    decodeNs = MLX90641_BenchNowNs() - start;
+
+    snprintf(message, sizeof(message), "HammingDecode %.0f ns per dump, reference %.0f ns", (double)decodeNs / runs,
+             (double)referenceNs / runs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_MEMORY(expected, actual, sizeof(actual));
+    TEST_ASSERT_TRUE(decodeNs < referenceNs);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_every_word);
+    RUN_TEST(test_error_order);
+    RUN_TEST(test_random_dumps);
+    RUN_TEST(test_speed);
+    return UNITY_END();
+}
@@ -0,0 +1,238 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "MLX90641_API.h"
+#include "MLX90641_I2C_Sim.h"
+
+#define SLAVE 0x33
+#define FRAMES 8
+
+static uint16_t eeData[832];
+static paramsMLX90641 params;
+static uint16_t frames[FRAMES][242];
+static float scenes[FRAMES][192];
+
+void setUp()
+{
+    uint16_t dump[832];
+
+    MLX90641_SimSyntheticEEPROM(eeData);
+    MLX90641_SimInit(SLAVE, eeData);
+    MLX90641_I2CSetBackend(MLX90641_SimBackend());
+    MLX90641_DumpEE(SLAVE, dump);
+    MLX90641_ExtractParameters(dump, &params);
+
+    for (int f = 0; f < FRAMES; f++)
+    {
+        for (int i = 0; i < 192; i++)
+        {
+            scenes[f][i] = -40.0f + (f * 192 + i) % 340;
+        }
+        MLX90641_SimSyntheticFrame(&params, scenes[f], 25.0f, f & 1, frames[f]);
+    }
+    MLX90641_SimSetFrames(&frames[0][0], FRAMES);
+}
+
+void tearDown()
+{
+}
+
+// the synthetic EEPROM survives the Hamming checked dump and the synthetic
+// frames compensate back to the scene they were made from
+void test_synthetic_round_trip()
+{
+    uint16_t dump[832];
+    float to[192];
+
+    MLX90641_SimInit(SLAVE, eeData);
+    TEST_ASSERT_EQUAL_INT(0, MLX90641_DumpEE(SLAVE, dump));
+    TEST_ASSERT_EQUAL_INT(0, MLX90641_ExtractParameters(dump, &params));
+
+    for (int f = 0; f < FRAMES; f++)
+    {
+        MLX90641_CalculateTo(frames[f], &params, 1.0f, MLX90641_GetTa(frames[f], &params), to);
+        for (int i = 0; i < 192; i++)
+        {
+            TEST_ASSERT_FLOAT_WITHIN(0.1f, scenes[f][i], to[i]);
+        }
+    }
+}
+
+// blocking reads at 16Hz: every sub-page arrives within one period plus its
+// own bus time, and the sub-pages come in device order
+void test_blocking_latency()
+{
+    const int periodUs = 2000000 >> 5;
+    uint16_t frameData[242];
+    float to[192];
+
+    TEST_ASSERT_EQUAL_INT(0, MLX90641_SetRefreshRate(SLAVE, 5));
+    TEST_ASSERT_EQUAL_INT(5, MLX90641_GetRefreshRate(SLAVE));
+    MLX90641_GetFrameData(SLAVE, frameData);
+
+    for (int k = 0; k < FRAMES; k++)
+    {
+        MLX90641_SimStats stats;
+        uint64_t start;
+        int subPage;
+
+        MLX90641_SimResetStats();
+        start = MLX90641_SimGetTimeNs();
+        subPage = MLX90641_GetFrameData(SLAVE, frameData);
+        MLX90641_SimGetStats(&stats);
+
+        TEST_ASSERT_TRUE(subPage == 0 || subPage == 1);
+        TEST_ASSERT_EQUAL_INT(subPage, MLX90641_GetSubPageNumber(frameData));
+        TEST_ASSERT_LESS_OR_EQUAL(periodUs + 15000, (int)((MLX90641_SimGetTimeNs() - start) / 1000));
+        TEST_ASSERT_EQUAL_INT(1, stats.measurements);
+
+        MLX90641_CalculateTo(frameData, &params, 1.0f, MLX90641_GetTa(frameData, &params), to);
+        TEST_ASSERT_FLOAT_WITHIN(0.5f, 25.0f, MLX90641_GetTa(frameData, &params));
+    }
+}
+
+// the non-blocking acquisition never holds the loop for longer than one
+// transfer, where two blocking reads per loop stall it for whole periods
+void test_poll_latency()
+{
+    MLX90641_SimTiming timing = {400, 0, 50000};
+    MLX90641_Acquisition acq;
+    uint16_t frameData[242];
+    uint64_t worstNs = 0;
+    int done = 0;
+    int polls = 0;
+
+    memset(&acq, 0, sizeof(acq));
+    MLX90641_SimSetTiming(&timing);
+    MLX90641_SetRefreshRate(SLAVE, 3);
+    MLX90641_StartFrameData(&acq, SLAVE, frameData);
+    while (done < 20 && polls < 200000)
+    {
+        uint64_t start = MLX90641_SimGetTimeNs();
+        int ready = MLX90641_PollFrameData(&acq);
+        uint64_t took = MLX90641_SimGetTimeNs() - start;
+
+        worstNs = took > worstNs ? took : worstNs;
+        polls++;
+        if (ready)
+        {
+            TEST_ASSERT_GREATER_OR_EQUAL(0, MLX90641_CompleteFrameData(&acq));
+            done++;
+            MLX90641_StartFrameData(&acq, SLAVE, frameData);
+        }
+        MLX90641_SimAdvance(200);
+    }
+
+    TEST_ASSERT_EQUAL_INT(20, done);
+    // one 128 byte transfer with its header is 2.9 ms at 400kHz
+    TEST_ASSERT_LESS_THAN(3000, (int)(worstNs / 1000));
+}
+
+// every Poll is one register access: a single read, except the step that
+// clears the ready flag, a write plus its verify read, once per sub-page
+void test_poll_transactions()
+{
+    MLX90641_Acquisition acq;
+    uint16_t frameData[242];
+    int writes = 0;
+    int done = 0;
+    int polls = 0;
+
+    memset(&acq, 0, sizeof(acq));
+    MLX90641_SetRefreshRate(SLAVE, 3);
+    MLX90641_StartFrameData(&acq, SLAVE, frameData);
+    while (done < 8 && polls < 200000)
+    {
+        MLX90641_SimStats stats;
+        int ready;
+
+        MLX90641_SimResetStats();
+        ready = MLX90641_PollFrameData(&acq);
+        MLX90641_SimGetStats(&stats);
+
+        TEST_ASSERT_LESS_OR_EQUAL(2, (int)stats.transactions);
+        writes += stats.transactions == 2;
+        polls++;
+        if (ready)
+        {
+            TEST_ASSERT_GREATER_OR_EQUAL(0, MLX90641_CompleteFrameData(&acq));
+            done++;
+            MLX90641_StartFrameData(&acq, SLAVE, frameData);
+        }
+        MLX90641_SimAdvance(200);
+    }
+
+    TEST_ASSERT_EQUAL_INT(8, done);
+    TEST_ASSERT_EQUAL_INT(8, writes);
+}
+
+// transfer that fetches the register at address in the planned reads, -1 if none
+static int transferOf(const MLX90641_Acquisition *acq, uint16_t address)
+{
+    int transfer = 0;
+
+    for (int step = 0; step < acq->stepCount; step++)
+    {
+        const MLX90641_ReadStep *read = &acq->steps[step];
+
+        if (address >= read->address && address < read->address + read->count)
+        {
+            return transfer;
+        }
+        if (step == acq->transferLast[transfer])
+        {
+            transfer++;
+        }
+    }
+    return -1;
+}
+
+// with the default read gap a refresh of the aux words is one read on either
+// sub-page, and the pixel blocks still take one read each
+void test_aux_refresh_plan()
+{
+    MLX90641_Acquisition acq;
+    uint16_t frameData[242];
+    uint8_t seen = 0;
+
+    memset(&acq, 0, sizeof(acq));
+    MLX90641_SetAuxRefresh(1);
+    for (int n = 0; n < 4; n++)
+    {
+        MLX90641_StartFrameData(&acq, SLAVE, frameData);
+        while (acq.state != MLX90641_ACQ_READ)
+        {
+            TEST_ASSERT_EQUAL_INT(0, MLX90641_PollFrameData(&acq));
+            MLX90641_SimAdvance(200);
+        }
+
+        int aux = transferOf(&acq, 0x0580);
+        TEST_ASSERT_GREATER_OR_EQUAL(0, aux);
+        TEST_ASSERT_EQUAL_INT(aux, transferOf(&acq, 0x0588));
+        TEST_ASSERT_EQUAL_INT(aux, transferOf(&acq, 0x058A));
+        TEST_ASSERT_EQUAL_INT(aux, transferOf(&acq, 0x05A0));
+        TEST_ASSERT_EQUAL_INT(aux, transferOf(&acq, 0x05AA));
+        TEST_ASSERT_EQUAL_INT(6, aux);
+        TEST_ASSERT_EQUAL_INT(n == 0 ? 8 : 7, acq.transferCount);
+        seen |= 1 << acq.subPage;
+
+        while (MLX90641_PollFrameData(&acq) == 0)
+        {
+        }
+        TEST_ASSERT_EQUAL_INT(acq.subPage, MLX90641_CompleteFrameData(&acq));
+    }
+    MLX90641_SetAuxRefresh(8);
+
+    TEST_ASSERT_EQUAL_INT(3, seen);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_synthetic_round_trip);
+    RUN_TEST(test_blocking_latency);
+    RUN_TEST(test_poll_latency);
+    RUN_TEST(test_poll_transactions);
+    RUN_TEST(test_aux_refresh_plan);
+    return UNITY_END();
+}
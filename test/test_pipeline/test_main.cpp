@@ -0,0 +1,185 @@
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "pipeline.h"
+
+// The pipeline on host threads (rtos_shim.cpp) with a fake sensor: every frame
+// is filled with its sequence number, so processing can tell a buffer that was
+// rewritten under it (torn) and frames that arrive out of order.
+
+#define FRAME_WORDS 768
+
+struct Fake
+{
+    int acquireMs;
+    int processMs;
+    int failEvery; // every n-th acquisition fails, 0 never
+    std::atomic<uint32_t> acquired;
+    std::atomic<uint32_t> processed;
+    std::atomic<uint32_t> lastProcessed;
+    std::atomic<uint32_t> torn;
+    std::atomic<uint32_t> outOfOrder;
+    std::atomic<uint32_t> failedSeen;
+    std::atomic<uint32_t> served;
+};
+
+static Fake fake;
+static Pipeline pipeline;
+
+static bool acquire(void *frame, void *context)
+{
+    Fake &sensor = *(Fake *)context;
+    uint32_t *words = (uint32_t *)frame;
+    uint32_t sequence = ++sensor.acquired;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(sensor.acquireMs));
+    for (int i = 0; i < FRAME_WORDS; i++)
+    {
+        words[i] = sequence;
+    }
+    if (sensor.failEvery != 0 && sequence % sensor.failEvery == 0)
+    {
+        words[0] = 0; // half read, must never reach processing
+        return false;
+    }
+    return true;
+}
+
+static void process(const void *frame, void *context)
+{
+    Fake &sensor = *(Fake *)context;
+    const uint32_t *words = (const uint32_t *)frame;
+    uint32_t sequence = words[FRAME_WORDS - 1];
+
+    if (sensor.failEvery != 0 && sequence % sensor.failEvery == 0)
+    {
+        sensor.failedSeen++;
+    }
+    if (sequence <= sensor.lastProcessed)
+    {
+        sensor.outOfOrder++;
+    }
+    sensor.lastProcessed = sequence;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(sensor.processMs));
+    for (int i = 0; i < FRAME_WORDS; i++)
+    {
+        if (words[i] != sequence)
+        {
+            sensor.torn++;
+            break;
+        }
+    }
+    sensor.processed++;
+}
+
+static void serve(void *context)
+{
+    ((Fake *)context)->served++;
+}
+
+// runs the pipeline for ms, pipeline.stats then holds the final statistics
+static void run(int acquireMs, int processMs, int failEvery, uint8_t buffers, int ms)
+{
+    PipelineConfig config;
+
+    fake.acquireMs = acquireMs;
+    fake.processMs = processMs;
+    fake.failEvery = failEvery;
+    fake.acquired = 0;
+    fake.processed = 0;
+    fake.lastProcessed = 0;
+    fake.torn = 0;
+    fake.outOfOrder = 0;
+    fake.failedSeen = 0;
+    fake.served = 0;
+
+    pipelineDefaults(config);
+    config.frameBytes = FRAME_WORDS * sizeof(uint32_t);
+    config.buffers = buffers;
+    config.acquire = acquire;
+    config.process = process;
+    config.serve = serve;
+    config.context = &fake;
+
+    TEST_ASSERT_TRUE(pipelineStart(pipeline, config));
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    pipelineStop(pipeline);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_rejects_pool_size()
+{
+    PipelineConfig config;
+
+    pipelineDefaults(config);
+    config.buffers = 1;
+    TEST_ASSERT_FALSE(pipelineStart(pipeline, config));
+    config.buffers = PIPELINE_MAX_BUFFERS + 1;
+    TEST_ASSERT_FALSE(pipelineStart(pipeline, config));
+}
+
+// processing keeps up: nothing is dropped and the ready queue stays short
+void test_keeps_up()
+{
+    run(10, 2, 0, 3, 600);
+    const PipelineStats &stats = pipeline.stats;
+
+    TEST_ASSERT_GREATER_THAN(20, stats.acquire.count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.errors);
+    TEST_ASSERT_LESS_OR_EQUAL(2, stats.readyHighWater);
+    TEST_ASSERT_GREATER_OR_EQUAL(stats.acquire.count - 1, stats.process.count);
+    TEST_ASSERT_EQUAL_UINT32(0, fake.torn);
+    TEST_ASSERT_EQUAL_UINT32(0, fake.outOfOrder);
+    TEST_ASSERT_GREATER_THAN(0, fake.served);
+}
+
+// processing ten times slower than the sensor: the oldest waiting frames are
+// dropped, the ready queue stays bounded by the pool and no buffer being
+// processed is ever written
+void test_drops_oldest()
+{
+    const uint8_t buffers = 3;
+    run(5, 50, 0, buffers, 800);
+    const PipelineStats &stats = pipeline.stats;
+
+    TEST_ASSERT_GREATER_THAN(5, stats.dropped);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, stats.readyHighWater);
+    TEST_ASSERT_LESS_OR_EQUAL(buffers, stats.readyHighWater);
+    TEST_ASSERT_LESS_THAN(stats.acquire.count / 4, stats.process.count);
+    // frames wait at most for the frame in progress
+    TEST_ASSERT_LESS_THAN(2 * 50000 + 20000, stats.wait.maxUs);
+    TEST_ASSERT_EQUAL_UINT32(0, fake.torn);
+    TEST_ASSERT_EQUAL_UINT32(0, fake.outOfOrder);
+}
+
+// failed reads are counted and their buffers go back to the pool unprocessed
+void test_acquire_errors()
+{
+    run(5, 1, 3, 2, 500);
+    const PipelineStats &stats = pipeline.stats;
+
+    TEST_ASSERT_GREATER_THAN(0, stats.errors);
+    TEST_ASSERT_GREATER_THAN(0, stats.process.count);
+    TEST_ASSERT_EQUAL_UINT32(0, fake.failedSeen);
+    TEST_ASSERT_EQUAL_UINT32(0, fake.torn);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rejects_pool_size);
+    RUN_TEST(test_keeps_up);
+    RUN_TEST(test_drops_oldest);
+    RUN_TEST(test_acquire_errors);
+    return UNITY_END();
+}
@@ -0,0 +1,118 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "MLX90641_API.h"
+#include "MLX90641_I2C_Sim.h"
+#include "../mlx90641_corpus.h"
+
+// MLX90641_CalculateToSimd pixel by pixel against MLX90641_CalculateTo: the
+// recorded frames, a sweep through every temperature range and frames with bad
+// pixels whose To is NaN.
+
+#define MAX_ERROR 0.001f
+
+int HammingDecode(uint16_t *eeData);
+
+static paramsMLX90641 params;
+static calibMLX90641 calib;
+
+// pixels that differ by more than MAX_ERROR or are NaN in only one of the results
+static int compare(uint16_t *frameData, float tr)
+{
+    float reference[192];
+    float result[192];
+    int mismatches = 0;
+
+    MLX90641_CalculateTo(frameData, &params, 0.95f, tr, reference);
+    MLX90641_CalculateToSimd(frameData, &params, &calib, 0.95f, tr, result, NULL, NULL);
+    for (int i = 0; i < 192; i++)
+    {
+        bool nan = reference[i] != reference[i];
+        if (nan != (result[i] != result[i]) || (!nan && fabsf(result[i] - reference[i]) > MAX_ERROR))
+        {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+void setUp()
+{
+    static uint16_t eeData[832];
+
+    memcpy(eeData, corpusEeData, sizeof(eeData));
+    HammingDecode(eeData);
+    MLX90641_ExtractParameters(eeData, &params);
+    MLX90641_CompileParameters(&params, &calib);
+}
+
+void tearDown()
+{
+}
+
+void test_corpus()
+{
+    uint16_t frameData[242];
+
+    for (int frame = 0; frame < CORPUS_FRAMES; frame++)
+    {
+        memcpy(frameData, corpusFrames + frame * 242, sizeof(frameData));
+        TEST_ASSERT_EQUAL_INT(0, compare(frameData, 17.0f));
+    }
+}
+
+// -40..300C in 0.1C steps, so every pixel range and corner is crossed
+void test_sweep()
+{
+    uint16_t frameData[242];
+    float scene[192];
+    int step = 0;
+
+    for (int subPage = 0; step <= 3400; subPage ^= 1)
+    {
+        for (int i = 0; i < 192; i++, step++)
+        {
+            scene[i] = -40.0f + (step <= 3400 ? step : 3400) * 0.1f;
+        }
+        MLX90641_SimSyntheticFrame(&params, scene, 25.0f, subPage, frameData);
+        TEST_ASSERT_EQUAL_INT(0, compare(frameData, 17.0f));
+    }
+}
+
+// raw readings far below anything the sensor sees leave no real fourth root;
+// both kernels must give NaN there and the same values elsewhere, and the
+// statistics leave the NaN pixels out
+void test_nan_pixels()
+{
+    static const int bad[] = {0, 5, 77, 128, 191};
+    uint16_t frameData[242];
+    float reference[192];
+    float result[192];
+    MLX90641_FrameStats stats;
+
+    memcpy(frameData, corpusFrames, sizeof(frameData));
+    for (int pixel : bad)
+    {
+        frameData[pixel] = 0x8000;
+    }
+
+    MLX90641_CalculateTo(frameData, &params, 0.95f, 17.0f, reference);
+    for (int pixel : bad)
+    {
+        TEST_ASSERT_TRUE(reference[pixel] != reference[pixel]);
+    }
+    TEST_ASSERT_EQUAL_INT(0, compare(frameData, 17.0f));
+
+    MLX90641_FrameStatsInit(&stats, 1000, 200);
+    MLX90641_CalculateToSimd(frameData, &params, &calib, 0.95f, 17.0f, result, NULL, &stats);
+    TEST_ASSERT_EQUAL_UINT16(192 - sizeof(bad) / sizeof(bad[0]), stats.count);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_corpus);
+    RUN_TEST(test_sweep);
+    RUN_TEST(test_nan_pixels);
+    return UNITY_END();
+}
@@ -0,0 +1,212 @@
+#include <unity.h>
+#include <math.h>
+#include "temporal_filter.h"
+
+// Step responses of the three filters, and how each treats a pixel that reads
+// NaN, at start or in the middle of a run.
+
+#define PIXELS 4
+
+static TemporalFilter filter;
+static TemporalFilterRange range;
+static float frame[PIXELS];
+
+static void start(uint8_t kind)
+{
+    TemporalFilterConfig config = temporalFilterDefaults();
+    config.kind = kind;
+    temporalFilterInit(filter, PIXELS, config);
+}
+
+// all pixels at value, returns the filtered frame
+static const float *step(float value)
+{
+    for (int i = 0; i < PIXELS; i++)
+    {
+        frame[i] = value;
+    }
+    return temporalFilterApply(filter, frame, PIXELS, range);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_off_passes_frame()
+{
+    start(TEMPORAL_FILTER_OFF);
+    TEST_ASSERT_TRUE(step(20) == frame);
+}
+
+// the mean of the last window frames: a 10 K step is through after window frames
+void test_average_step()
+{
+    start(TEMPORAL_FILTER_AVERAGE);
+    for (int k = 0; k < 6; k++)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, 20.0f, step(20)[0]);
+    }
+
+    static const float expected[] = {22.5f, 25.0f, 27.5f, 30.0f, 30.0f};
+    for (float value : expected)
+    {
+        const float *out = step(30);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, value, out[0]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, value, range.max);
+        TEST_ASSERT_EQUAL_UINT16(PIXELS, range.count);
+    }
+}
+
+void test_ewma_step()
+{
+    start(TEMPORAL_FILTER_EWMA);
+    step(20);
+
+    float expected = 20;
+    for (int k = 0; k < 10; k++)
+    {
+        expected += filter.state.config.alpha * (30 - expected);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, expected, step(30)[0]);
+    }
+    TEST_ASSERT_TRUE(expected > 29.7f);
+}
+
+// noise sized steps are smoothed, a person walking in passes the gate at once
+void test_kalman_step()
+{
+    start(TEMPORAL_FILTER_KALMAN);
+    for (int k = 0; k < 20; k++)
+    {
+        step(20);
+    }
+
+    float previous = step(20.5f)[0];
+    TEST_ASSERT_TRUE(previous > 20.0f && previous < 20.4f);
+    for (int k = 0; k < 20; k++)
+    {
+        float out = step(20.5f)[0];
+        TEST_ASSERT_TRUE(out >= previous && out <= 20.5f);
+        previous = out;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.5f, previous);
+
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, step(30)[0]);
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, step(30)[0]);
+}
+
+// a pixel that is NaN from the start stays NaN, is left out of the range and
+// starts at its first number without a ramp from 0
+void test_nan_at_start()
+{
+    static const uint8_t kinds[] = {TEMPORAL_FILTER_AVERAGE, TEMPORAL_FILTER_EWMA, TEMPORAL_FILTER_KALMAN};
+
+    for (uint8_t kind : kinds)
+    {
+        start(kind);
+        for (int k = 0; k < 6; k++)
+        {
+            frame[0] = 21;
+            frame[1] = 22;
+            frame[2] = NAN;
+            frame[3] = 23;
+            const float *out = temporalFilterApply(filter, frame, PIXELS, range);
+            TEST_ASSERT_TRUE(out[2] != out[2]);
+            TEST_ASSERT_EQUAL_UINT16(PIXELS - 1, range.count);
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f, 21.0f, range.min);
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f, 66.0f, range.sum);
+        }
+
+        frame[2] = 25;
+        const float *out = temporalFilterApply(filter, frame, PIXELS, range);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, 25.0f, out[2]);
+        TEST_ASSERT_EQUAL_UINT16(PIXELS, range.count);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, 21.0f, range.min);
+    }
+}
+
+// a NaN in the middle of a run holds the pixel, and the average is exact again
+// once the held frame has left the window
+void test_nan_hold()
+{
+    static const uint8_t kinds[] = {TEMPORAL_FILTER_AVERAGE, TEMPORAL_FILTER_EWMA, TEMPORAL_FILTER_KALMAN};
+
+    for (uint8_t kind : kinds)
+    {
+        start(kind);
+        for (int k = 0; k < 10; k++)
+        {
+            step(20);
+        }
+        frame[1] = NAN;
+        const float *out = temporalFilterApply(filter, frame, PIXELS, range);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, 20.0f, out[1]);
+        TEST_ASSERT_EQUAL_UINT16(PIXELS, range.count);
+    }
+
+    start(TEMPORAL_FILTER_AVERAGE);
+    static const float run[] = {20, 21, 22, NAN, 24, 25, 26, 27, 28};
+    for (float value : run)
+    {
+        step(value);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 26.5f, filter.output[0]);
+}
+
+// a changed window restarts the ring instead of mixing old slots in
+void test_window_change()
+{
+    start(TEMPORAL_FILTER_AVERAGE);
+    for (int k = 0; k < 6; k++)
+    {
+        step(20);
+    }
+    filter.state.config.window = 2;
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 30.0f, step(30)[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 35.0f, step(40)[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 45.0f, step(50)[0]);
+}
+
+// only the state of the active kind is allocated, and none while off
+void test_state_per_kind()
+{
+    start(TEMPORAL_FILTER_OFF);
+    step(20);
+    TEST_ASSERT_EQUAL_UINT32(0, temporalFilterBytes(filter));
+
+    filter.state.config.kind = TEMPORAL_FILTER_EWMA;
+    step(20);
+    TEST_ASSERT_EQUAL_UINT32(PIXELS * 4, temporalFilterBytes(filter));
+
+    filter.state.config.kind = TEMPORAL_FILTER_KALMAN;
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 30.0f, step(30)[0]);
+    TEST_ASSERT_EQUAL_UINT32(PIXELS * 8, temporalFilterBytes(filter));
+
+    filter.state.config.kind = TEMPORAL_FILTER_AVERAGE;
+    filter.state.config.window = 3;
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 40.0f, step(40)[0]);
+    TEST_ASSERT_EQUAL_UINT32(PIXELS * (8 + 3 * 2), temporalFilterBytes(filter));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 45.0f, step(50)[0]);
+
+    filter.state.config.kind = TEMPORAL_FILTER_OFF;
+    TEST_ASSERT_TRUE(step(20) == frame);
+    TEST_ASSERT_EQUAL_UINT32(0, temporalFilterBytes(filter));
+    TEST_ASSERT_NULL(filter.output);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_off_passes_frame);
+    RUN_TEST(test_average_step);
+    RUN_TEST(test_ewma_step);
+    RUN_TEST(test_kalman_step);
+    RUN_TEST(test_nan_at_start);
+    RUN_TEST(test_nan_hold);
+    RUN_TEST(test_window_change);
+    RUN_TEST(test_state_per_kind);
+    return UNITY_END();
+}
@@ -0,0 +1,213 @@
+#include <unity.h>
+#include <string.h>
+#include "tracker.h"
+
+// Scripted walks through a 16 row frame: track ids must survive a missed
+// frame and people passing each other, and the counting line must count each
+// crossing once in the right direction.
+
+static Tracker tracker;
+
+// one frame of blobs at the given centroids
+static BlobList people(int count, const float *rows, const float *cols)
+{
+    BlobList list;
+
+    memset(&list, 0, sizeof(list));
+    list.count = count;
+    for (int i = 0; i < count; i++)
+    {
+        list.blobs[i].centroidRow = rows[i];
+        list.blobs[i].centroidCol = cols[i];
+        list.blobs[i].area = 4;
+    }
+    return list;
+}
+
+static const Track *trackNear(float col)
+{
+    for (int t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        const Track &track = tracker.tracks[t];
+        if (track.id != 0 && track.col > col - 2 && track.col < col + 2)
+        {
+            return &track;
+        }
+    }
+    return NULL;
+}
+
+void setUp()
+{
+    TrackerConfig config = trackerDefaults();
+    config.lineRow = 8;
+    trackerInit(tracker, config);
+}
+
+void tearDown()
+{
+}
+
+// A walks down column 3 and is missed in frame 5, B walks up column 9
+void test_opposite_walks()
+{
+    uint16_t idA = 0;
+    uint16_t idB = 0;
+
+    for (int f = 0; f < 15; f++)
+    {
+        float rows[2];
+        float cols[2];
+        int n = 0;
+        if (f != 5)
+        {
+            rows[n] = 1.0f + f;
+            cols[n++] = 3;
+        }
+        rows[n] = 15.0f - f;
+        cols[n++] = 9;
+        trackerUpdate(tracker, people(n, rows, cols));
+
+        const Track *a = trackNear(3);
+        const Track *b = trackNear(9);
+        TEST_ASSERT_NOT_NULL(a);
+        TEST_ASSERT_NOT_NULL(b);
+        if (f == 0)
+        {
+            idA = a->id;
+            idB = b->id;
+            TEST_ASSERT_EQUAL_INT(0, trackerCount(tracker));
+            continue;
+        }
+        TEST_ASSERT_EQUAL_UINT16(idA, a->id);
+        TEST_ASSERT_EQUAL_UINT16(idB, b->id);
+        TEST_ASSERT_EQUAL_INT(2, trackerCount(tracker));
+    }
+    TEST_ASSERT_NOT_EQUAL(idA, idB);
+    TEST_ASSERT_EQUAL_UINT32(1, tracker.lineIn);
+    TEST_ASSERT_EQUAL_UINT32(1, tracker.lineOut);
+}
+
+// two people walking down side by side keep their ids and count twice
+void test_side_by_side()
+{
+    uint16_t ids[2] = {};
+
+    for (int f = 0; f < 15; f++)
+    {
+        const float rows[2] = {1.0f + f, 1.5f + f};
+        const float cols[2] = {3, 8};
+        trackerUpdate(tracker, people(2, rows, cols));
+
+        for (int i = 0; i < 2; i++)
+        {
+            const Track *track = trackNear(cols[i]);
+            TEST_ASSERT_NOT_NULL(track);
+            if (f == 0)
+            {
+                ids[i] = track->id;
+            }
+            TEST_ASSERT_EQUAL_UINT16(ids[i], track->id);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, tracker.lineIn);
+    TEST_ASSERT_EQUAL_UINT32(0, tracker.lineOut);
+}
+
+// standing on the line, or stepping up to it and back, is no crossing;
+// walking in and back out again counts both ways
+void test_line_margin()
+{
+    static const float dither[] = {7.7f, 8.3f, 7.8f, 8.4f, 8.0f, 7.6f, 8.2f, 7.0f, 6.5f, 7.9f, 8.4f, 7.0f};
+    const float col = 5;
+
+    for (float row : dither)
+    {
+        trackerUpdate(tracker, people(1, &row, &col));
+    }
+    TEST_ASSERT_EQUAL_INT(1, trackerCount(tracker));
+    TEST_ASSERT_EQUAL_UINT32(0, tracker.lineIn);
+    TEST_ASSERT_EQUAL_UINT32(0, tracker.lineOut);
+
+    static const float back[] = {7.0f, 8.0f, 9.0f, 10.0f, 9.0f, 8.0f, 7.0f, 6.0f};
+    for (float row : back)
+    {
+        trackerUpdate(tracker, people(1, &row, &col));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, tracker.lineIn);
+    TEST_ASSERT_EQUAL_UINT32(1, tracker.lineOut);
+}
+
+// a blob seen in a single frame never counts as a person
+void test_noise_not_confirmed()
+{
+    const float row = 4;
+    const float col = 4;
+
+    trackerUpdate(tracker, people(1, &row, &col));
+    TEST_ASSERT_EQUAL_INT(0, trackerCount(tracker));
+    trackerUpdate(tracker, people(0, NULL, NULL));
+    trackerUpdate(tracker, people(0, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(0, trackerCount(tracker));
+    TEST_ASSERT_NULL(trackNear(col));
+}
+
+// a confirmed person is kept for dropFrames missed frames, then removed
+void test_drop_after_misses()
+{
+    const float row = 4;
+    const float col = 4;
+
+    trackerUpdate(tracker, people(1, &row, &col));
+    trackerUpdate(tracker, people(1, &row, &col));
+    TEST_ASSERT_EQUAL_INT(1, trackerCount(tracker));
+    uint16_t id = trackNear(col)->id;
+
+    for (int miss = 1; miss <= tracker.config.dropFrames; miss++)
+    {
+        trackerUpdate(tracker, people(0, NULL, NULL));
+        TEST_ASSERT_EQUAL_INT(1, trackerCount(tracker));
+    }
+    trackerUpdate(tracker, people(1, &row, &col));
+    TEST_ASSERT_EQUAL_UINT16(id, trackNear(col)->id);
+
+    for (int miss = 0; miss <= tracker.config.dropFrames; miss++)
+    {
+        trackerUpdate(tracker, people(0, NULL, NULL));
+    }
+    TEST_ASSERT_EQUAL_INT(0, trackerCount(tracker));
+
+    // coming back later is a new person
+    trackerUpdate(tracker, people(1, &row, &col));
+    TEST_ASSERT_NOT_EQUAL(id, trackNear(col)->id);
+}
+
+// more people than track slots: the extra blobs are ignored, nothing overruns
+void test_full_table()
+{
+    float rows[BLOB_MAX_BLOBS];
+    float cols[BLOB_MAX_BLOBS];
+
+    for (int i = 0; i < BLOB_MAX_BLOBS; i++)
+    {
+        rows[i] = (i % 4) * 4;
+        cols[i] = (i / 4) * 4;
+    }
+    for (int f = 0; f < 5; f++)
+    {
+        trackerUpdate(tracker, people(BLOB_MAX_BLOBS, rows, cols));
+    }
+    TEST_ASSERT_EQUAL_INT(TRACKER_MAX_TRACKS, trackerCount(tracker));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_opposite_walks);
+    RUN_TEST(test_side_by_side);
+    RUN_TEST(test_line_margin);
+    RUN_TEST(test_noise_not_confirmed);
+    RUN_TEST(test_drop_after_misses);
+    RUN_TEST(test_full_table);
+    return UNITY_END();
+}
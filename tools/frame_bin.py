@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""Reference decoder for the /frame.bin format described in include/frame_bin.h.
+
+    python3 tools/frame_bin.py http://192.168.1.123 [count]
+
+polls the endpoint, asking for deltas against the last frame it decoded, and
+prints one line per frame.
+"""
+import struct
+import sys
+import time
+import urllib.request
+
+MAGIC = b"TVFB"
+VERSION = 1
+DELTA = 0x01
+INVALID = -32768
+HEADER = struct.Struct("<4sBBH8sBBHIIhH")
+
+
+class Frame:
+    def __init__(self, sensor, rows, cols, scale, timestamp, sequence, ta, pixels):
+        self.sensor = sensor
+        self.rows = rows
+        self.cols = cols
+        self.scale = scale
+        self.timestamp = timestamp
+        self.sequence = sequence
+        self.ta = ta
+        self.pixels = pixels  # raw int16 values, row by row
+
+    def temperatures(self):
+        """Pixels in degrees C, None where the sensor gave no number."""
+        return [None if p == INVALID else p / self.scale for p in self.pixels]
+
+
+def decode(data, previous=None):
+    """Decodes one /frame.bin body; previous must be given for a delta body."""
+    (magic, version, flags, header_size, sensor, rows, cols, scale,
+     timestamp, sequence, ta, _) = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not a version %d frame" % VERSION)
+    count = rows * cols
+
+    if not flags & DELTA:
+        pixels = list(struct.unpack_from("<%dh" % count, data, header_size))
+    else:
+        if previous is None or previous.sequence != sequence - 1 or len(previous.pixels) != count:
+            raise ValueError("delta frame %d needs frame %d" % (sequence, sequence - 1))
+        pixels = []
+        offset = header_size
+        for base in previous.pixels:
+            value = shift = 0
+            while True:
+                byte = data[offset]
+                offset += 1
+                value |= (byte & 0x7F) << shift
+                shift += 7
+                if byte < 0x80:
+                    break
+            pixels.append(base + ((value >> 1) ^ -(value & 1)))
+
+    sensor = sensor.rstrip(b"\0").decode("ascii")
+    return Frame(sensor, rows, cols, scale, timestamp, sequence, ta / scale, pixels)
+
+
+def main():
+    url = sys.argv[1].rstrip("/") + "/frame.bin"
+    count = int(sys.argv[2]) if len(sys.argv) > 2 else 10
+    frame = None
+    period = 0.0625  # 16 Hz until two frames tell the real period
+    while count > 0:
+        query = "?base=%d" % frame.sequence if frame else ""
+        with urllib.request.urlopen(url + query) as response:
+            data = response.read()
+        if frame is not None and HEADER.unpack_from(data)[9] == frame.sequence:
+            time.sleep(period / 2)  # no new frame yet
+            continue
+        previous = frame
+        frame = decode(data, frame)
+        if previous is not None and frame.sequence > previous.sequence:
+            elapsed = (frame.timestamp - previous.timestamp) & 0xFFFFFFFF
+            period = elapsed / 1000.0 / (frame.sequence - previous.sequence)
+        values = [t for t in frame.temperatures() if t is not None]
+        print("#%d %d ms Ta %.2f min %.2f max %.2f (%d bytes)" %
+              (frame.sequence, frame.timestamp, frame.ta, min(values), max(values), len(data)))
+        count -= 1
+
+
+if __name__ == "__main__":
+    main()